@@ -1,5 +1,6 @@
 import os
 import random
+import subprocess
 
 # Operações incluídas (códigos: 1,2,3,4,6)
 OP_TYPES = [
@@ -10,6 +11,11 @@ OP_TYPES = [
     ("multiplicacao", 6),
 ]
 
+# Consultas ao produto A*B sob demanda (ops 7, 8 e 9). Só o algoritmo2
+# implementa essas operações, então elas ficam num arquivo à parte
+# (teste_produto.txt), fora de OP_TYPES, que é compartilhado por todos.
+PRODUTO_NOME = "produto"
+
 def _gera_matriz(N, k, rng):
     # Gera 'k' posições únicas com valores aleatórios
     # Se k for muito próximo de N*N, a abordagem de set é lenta, mas para matriz esparsa ok.
@@ -38,6 +44,38 @@ def _linha_matriz(elems, N):
     out += [f"{i} {j} {v}" for (i, j, v) in elems]
     return out
 
+def _gerador_cpp():
+    # Executável compilado por main.py a partir de src/gerador.cpp
+    for nome in ("./gerador", "./gerador.exe"):
+        if os.path.exists(nome):
+            return nome
+    return None
+
+def _bloco_matriz(N, k, rng, dist="uniforme"):
+    # Bloco de texto de uma matriz ("k N" + k linhas).
+    # Usa o gerador C++ (paralelo, sem conjunto global) quando disponível;
+    # o fallback em Python só cobre a distribuição uniforme.
+    # "--ordem aleatoria": a ordem padrão do gerador (por linha e coluna) é o
+    # melhor caso de carga para as estruturas ordenadas e distorceria o teste
+    # de inserção; o fallback em Python já sai em ordem aleatória.
+    seed = rng.getrandbits(63)
+    exe = _gerador_cpp()
+    if exe is not None:
+        res = subprocess.run(
+            [exe, str(N), str(k), "--dist", dist, "--ordem", "aleatoria", "--seed", str(seed)],
+            check=True, capture_output=True, text=True
+        )
+        return res.stdout.rstrip("\n")
+    if dist != "uniforme":
+        raise RuntimeError(f"Distribuição '{dist}' requer o executável ./gerador (src/gerador.cpp).")
+    return "\n".join(_linha_matriz(_gera_matriz(N, k, rng), N))
+
+def pair_dir_name(N, K, dist="uniforme"):
+    # A distribuição uniforme mantém o nome original dos diretórios
+    if dist == "uniforme":
+        return f"N_{N}_K_{K}"
+    return f"N_{N}_K_{K}_{dist}"
+
 def _gera_queries(tipo_nome, tipo_cod, N, rng, qtd=1000):
     qs = []
     for _ in range(qtd):
@@ -61,21 +99,45 @@ def _gera_queries(tipo_nome, tipo_cod, N, rng, qtd=1000):
             qs.append("6")
     return qs
 
-def write_test_files(N, K, base_dir):
+def _gera_queries_produto(N, rng, qtd=2000):
+    # Mistura entradas, linhas e posições mascaradas com algumas escritas e
+    # transposições, para exercitar a invalidação dos caches do LazyProduct.
+    qs = []
+    for _ in range(qtd):
+        r = rng.random()
+        if r < 0.45:
+            qs.append(f"7 {rng.randrange(N)} {rng.randrange(N)}")
+        elif r < 0.70:
+            qs.append(f"8 {rng.randrange(N)}")
+        elif r < 0.85:
+            q = rng.randint(1, 16)
+            pos = " ".join(f"{rng.randrange(N)} {rng.randrange(N)}" for _ in range(q))
+            qs.append(f"9 {q} {pos}")
+        elif r < 0.98:
+            m = rng.choice([1, 2])
+            qs.append(f"2 {m} {rng.randrange(N)} {rng.randrange(N)} {rng.randint(0, 100)}")
+        else:
+            qs.append(f"3 {rng.choice([1, 2])}")
+    return qs
+
+def write_test_files(N, K, base_dir, dist="uniforme"):
     # Seed fixa para reprodutibilidade baseada nos parâmetros
     rng = random.Random(hash((N, K)) & 0xFFFFFFFF)
-    dir_pair = os.path.join(base_dir, f"N_{N}_K_{K}")
+    dir_pair = os.path.join(base_dir, pair_dir_name(N, K, dist))
     os.makedirs(dir_pair, exist_ok=True)
 
+    nomes = ["insercao"] + [nome for nome, _ in OP_TYPES] + [PRODUTO_NOME]
+    if all(os.path.exists(os.path.join(dir_pair, f"teste_{nome}.txt")) for nome in nomes):
+        return
+
     # Gera matrizes base A e B
-    # Se N for gigante (10^6) e K pequeno, isso é rápido.
-    A = _gera_matriz(N, K, rng)
-    B = _gera_matriz(N, K, rng)
+    A = _bloco_matriz(N, K, rng, dist)
+    B = _bloco_matriz(N, K, rng, dist)
 
     # Arquivo 1: apenas inserção/carregamento (Q=0)
     insercao_path = os.path.join(dir_pair, "teste_insercao.txt")
     if not os.path.exists(insercao_path):
-        linhas = _linha_matriz(A, N) + _linha_matriz(B, N) + ["0"]
+        linhas = [A, B, "0"]
         with open(insercao_path, "w") as f:
             f.write("\n".join(linhas))
     
@@ -97,16 +159,24 @@ def write_test_files(N, K, base_dir):
             qtd = 10000 # Testar throughput de consultas
             
         queries = _gera_queries(nome, cod, N, rng, qtd=qtd)
-        linhas = _linha_matriz(A, N) + _linha_matriz(B, N) + [str(len(queries))] + queries
+        linhas = [A, B, str(len(queries))] + queries
+        with open(path, "w") as f:
+            f.write("\n".join(linhas))
+
+    # Produto sob demanda (só algoritmo2)
+    path = os.path.join(dir_pair, f"teste_{PRODUTO_NOME}.txt")
+    if not os.path.exists(path):
+        queries = _gera_queries_produto(N, rng)
+        linhas = [A, B, str(len(queries))] + queries
         with open(path, "w") as f:
             f.write("\n".join(linhas))
 
-def ensure_tests_for_pairs(pairs, base_dir="tests"):
+def ensure_tests_for_pairs(pairs, base_dir="tests", dist="uniforme"):
     """Garante que os arquivos de teste existam para todos os pares (N, K)."""
-    print(f"Verificando/Gerando arquivos de teste em '{base_dir}'...")
+    print(f"Verificando/Gerando arquivos de teste em '{base_dir}' (distribuição: {dist})...")
     count = 0
     for (N, K) in pairs:
-        write_test_files(N, K, base_dir)
+        write_test_files(N, K, base_dir, dist)
         count += 1
         if count % 5 == 0:
             print(f"Processados {count}/{len(pairs)} pares...")
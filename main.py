@@ -10,7 +10,7 @@ from concurrent.futures import ThreadPoolExecutor, as_completed
 
 # --- IMPORTANTE: Certifique-se de que gerador_testes.py está na mesma pasta ---
 try:
-    from gerador_testes import ensure_tests_for_pairs
+    from gerador_testes import ensure_tests_for_pairs, pair_dir_name, PRODUTO_NOME
 except ImportError:
     print("ERRO: 'gerador_testes.py' não encontrado. O script não pode gerar os casos de teste.")
     exit(1)
@@ -18,7 +18,13 @@ except ImportError:
 # --- Configuração dos Experimentos ---
 
 N_values = [100, 1000, 10000, 100000, 1000000] 
-# N=100 será o único onde testaremos a matriz densa/linear
+# A matriz densa aloca N*N posições: só é testada até este N
+DENSE_MAX_N = 1000
+# Padrão de esparsidade dos testes (ver src/gerador.cpp):
+# uniforme, potencia, banda, blocos ou duplicados
+DIST = "uniforme"
+# O modo --verifica do algoritmo2 refaz multiply() a cada escrita: só para N pequeno
+VERIFICA_MAX_N = 100
 num_runs = 6
 
 # --- Funções Auxiliares ---
@@ -30,8 +36,17 @@ def compile_cpp_programs():
         "gerador": "src/gerador.cpp",
         "algoritmo1": "src/algoritmo1.cpp",
         "algoritmo2": "src/algoritmo2.cpp",
+        "algoritmo_concorrente": "src/algoritmo_concorrente.cpp",
+        "algoritmo_delta": "src/algoritmo_delta.cpp",
         "algoritmo_denso": "src/algoritmo_denso.cpp"
     }
+    # Flags extras por executável (o denso usa AVX2 e threads no GEMM)
+    extra_flags = {
+        "gerador": ["-pthread"],
+        "algoritmo_concorrente": ["-pthread"],
+        "algoritmo_delta": ["-pthread"],
+        "algoritmo_denso": ["-march=native", "-pthread"],
+    }
     
     # Cria pasta src caso não exista e move arquivos se necessário (opcional, apenas organização)
     # Aqui assumimos que o usuário já tem os arquivos ou na raiz ou em src/
@@ -48,7 +63,7 @@ def compile_cpp_programs():
         print(f"Compilando {source} -> {executable}...")
         try:
             subprocess.run(
-                ["g++", "-o", executable, source, "-O3", "-std=c++17"],
+                ["g++", "-o", executable, source, "-O3", "-std=c++17"] + extra_flags.get(executable, []),
                 check=True,
                 capture_output=True,
                 text=True
@@ -62,10 +77,10 @@ def compile_cpp_programs():
     return True
 
 def run_experiment(N, k, runs):
-    """Executa experimentos. Denso roda apenas se N=100."""
+    """Executa experimentos. Denso roda apenas se N <= DENSE_MAX_N."""
     # print(f"Executando para N={N}, k={k}...") # Comentei para limpar o output
     base_dir = "tests"
-    pair_dir = os.path.join(base_dir, f"N_{N}_K_{k}")
+    pair_dir = os.path.join(base_dir, pair_dir_name(N, k, DIST))
     file_types = [
         ("insercao", "teste_insercao.txt"),
         ("consulta", "teste_consulta.txt"),
@@ -73,10 +88,11 @@ def run_experiment(N, k, runs):
         ("transpose", "teste_transpose.txt"),
         ("soma", "teste_soma.txt"),
         ("multiplicacao", "teste_multiplicacao.txt"),
+        (PRODUTO_NOME, f"teste_{PRODUTO_NOME}.txt"),
     ]
     results = []
     
-    run_dense = (N == 100)
+    run_dense = (N <= DENSE_MAX_N)
 
     for tipo, fname in file_types:
         path = os.path.join(pair_dir, fname)
@@ -87,15 +103,23 @@ def run_experiment(N, k, runs):
         
         times_algo1 = []
         times_algo2 = []
+        times_conc = []
+        times_delta = []
         times_dense = []
 
+        # Ops 7–9 (produto sob demanda) só existem no algoritmo2
+        run_others = (tipo != PRODUTO_NOME)
+
         for i in range(runs):
             # Algoritmo 1
-            try:
-                start = time.perf_counter()
-                subprocess.run(["./algoritmo1"], input=test_input, text=True, capture_output=True, check=True)
-                times_algo1.append(time.perf_counter() - start)
-            except Exception:
+            if run_others:
+                try:
+                    start = time.perf_counter()
+                    subprocess.run(["./algoritmo1"], input=test_input, text=True, capture_output=True, check=True)
+                    times_algo1.append(time.perf_counter() - start)
+                except Exception:
+                    times_algo1.append(np.nan)
+            else:
                 times_algo1.append(np.nan)
             
             # Algoritmo 2
@@ -106,8 +130,30 @@ def run_experiment(N, k, runs):
             except Exception:
                 times_algo2.append(np.nan)
 
+            # Algoritmo Concorrente (leitores em paralelo com o escritor)
+            if run_others:
+                try:
+                    start = time.perf_counter()
+                    subprocess.run(["./algoritmo_concorrente"], input=test_input, text=True, capture_output=True, check=True)
+                    times_conc.append(time.perf_counter() - start)
+                except Exception:
+                    times_conc.append(np.nan)
+            else:
+                times_conc.append(np.nan)
+
+            # Algoritmo Delta (CSR + buffer de escrita)
+            if run_others:
+                try:
+                    start = time.perf_counter()
+                    subprocess.run(["./algoritmo_delta"], input=test_input, text=True, capture_output=True, check=True)
+                    times_delta.append(time.perf_counter() - start)
+                except Exception:
+                    times_delta.append(np.nan)
+            else:
+                times_delta.append(np.nan)
+
             # Algoritmo Denso
-            if run_dense:
+            if run_dense and run_others:
                 try:
                     start = time.perf_counter()
                     subprocess.run(["./algoritmo_denso"], input=test_input, text=True, capture_output=True, check=True, timeout=60)
@@ -125,10 +171,13 @@ def run_experiment(N, k, runs):
             "N": N,
             "k": k,
             "sparsity": k / (N*N),
+            "dist": DIST,
             "test_type": tipo,
             "time_algo1": np.mean(times_algo1),
             "time_algo2": np.mean(times_algo2),
-            "time_dense": np.mean(times_dense) if run_dense and times_dense else np.nan
+            "time_conc": np.mean(times_conc),
+            "time_delta": np.mean(times_delta),
+            "time_dense": np.mean(times_dense) if run_dense and run_others and times_dense else np.nan
         })
     return results
 
@@ -152,7 +201,7 @@ def plot_results(df):
 
     df_melted = df.melt(
         id_vars=['N', 'k', 'sparsity', 'test_type'], 
-        value_vars=['time_algo1', 'time_algo2', 'time_dense'], 
+        value_vars=['time_algo1', 'time_algo2', 'time_conc', 'time_delta', 'time_dense'], 
         var_name='Algoritmo', 
         value_name='Tempo (s)'
     )
@@ -160,6 +209,8 @@ def plot_results(df):
     nome_map = {
         'time_algo1': 'Algoritmo 1 (Map)',
         'time_algo2': 'Algoritmo 2 (Vector/Map)',
+        'time_conc': 'Concorrente (HAMT/EBR)',
+        'time_delta': 'Delta (CSR + buffer)',
         'time_dense': 'Denso (Ref)'
     }
     df_melted['Algoritmo'] = df_melted['Algoritmo'].map(nome_map)
@@ -209,6 +260,23 @@ def plot_results(df):
         plt.close()
         print(f"  Gráfico salvo: {filename}")
 
+def verify_lazy_product(pares):
+    """Confere as ops 7–9 do algoritmo2 contra multiply() (modo --verifica)."""
+    ok = True
+    for (n, k) in pares:
+        if n > VERIFICA_MAX_N:
+            continue
+        path = os.path.join("tests", pair_dir_name(n, k, DIST), f"teste_{PRODUTO_NOME}.txt")
+        if not os.path.exists(path):
+            continue
+        with open(path, "r") as f:
+            test_input = f.read()
+        res = subprocess.run(["./algoritmo2", "--verifica"], input=test_input, text=True, capture_output=True)
+        if res.returncode != 0:
+            print(f"ERRO: produto sob demanda diverge de multiply() em N={n}, k={k}: {res.stderr.strip()}")
+            ok = False
+    return ok
+
 # --- Função Principal ---
 
 def main():
@@ -241,8 +309,13 @@ def main():
     # --- 2. Geração dos Arquivos de Teste ---
     # Chamada explícita ao gerador_testes.py
     print("\nIniciando geração de casos de teste...")
-    ensure_tests_for_pairs(pares, base_dir="tests")
+    ensure_tests_for_pairs(pares, base_dir="tests", dist=DIST)
     print("Geração de testes concluída.\n")
+
+    print("Validando o produto sob demanda do algoritmo2...")
+    if not verify_lazy_product(pares):
+        return
+    print("Validação concluída.\n")
     
     # --- 3. Execução dos Experimentos ---
     max_workers = min(len(pares), os.cpu_count()-2 or 1)
@@ -5,6 +5,10 @@
 #include <memory>
 #include <cmath>
 #include <algorithm>
+#include <cstdint>
+#include <climits>
+#include <unordered_map>
+#include <string>
 
 const long long MOD = 1000000;
 
@@ -12,6 +16,33 @@ class SparseMatrix {
 public:
     struct Core {
         std::map<std::pair<int,int>, long long> data;
+
+        // Mantido só depois de startTracking() (quando um LazyProduct observa
+        // a matriz): cada escrita carimba sua linha e coluna físicas com um
+        // novo valor de version, e byCol espelha data em ordem (coluna, linha)
+        // para que uma coluna física possa ser lida isoladamente.
+        bool tracking = false;
+        uint64_t version = 0;
+        std::vector<uint64_t> rowVersion, colVersion;
+        std::map<std::pair<int,int>, long long> byCol;
+
+        void startTracking(int n) {
+            if (tracking) return;
+            tracking = true;
+            rowVersion.assign(n, 0);
+            colVersion.assign(n, 0);
+            for (const auto &kv : data)
+                byCol.emplace_hint(byCol.end(),
+                    std::make_pair(kv.first.second, kv.first.first), kv.second);
+        }
+
+        // Chamada após cada escrita em (r,c); v é o valor resultante (0 = removido).
+        void touched(int r, int c, long long v) {
+            if (!tracking) return;
+            rowVersion[r] = colVersion[c] = ++version;
+            if (v == 0LL) byCol.erase({c, r});
+            else          byCol[{c, r}] = v;
+        }
     };
 
     int n;
@@ -47,6 +78,7 @@ public:
         } else {
             core->data[key] = v;
         }
+        core->touched(bi, bj, v);
     }
 
     void addValue(int i, int j, long long delta) {
@@ -54,14 +86,16 @@ public:
         int bj = transposed ? i : j;
         auto key = std::make_pair(bi,bj);
         auto it = core->data.find(key);
+        long long nv = delta;
         if (it == core->data.end()) {
             if (delta != 0LL)
                 core->data[key] = delta;
         } else {
-            long long nv = it->second + delta;
+            nv = it->second + delta;
             if (nv == 0LL) core->data.erase(it);
             else it->second = nv;
         }
+        core->touched(bi, bj, nv);
     }
 
     void toggleTranspose() {
@@ -163,7 +197,207 @@ public:
     }
 };
 
-int main() {
+
+// Produto C = A * B sob demanda: C(i,j) é o produto escalar esparso da linha i
+// de A com a coluna j de B, sem materializar C. Guarda referências para A e B;
+// as linhas/colunas extraídas são reaproveitadas entre consultas; uma escrita
+// invalida só a linha e a coluna que tocou, e a transposição invalida tudo.
+class LazyProduct {
+public:
+    // Linha (ou coluna) ordenada pelo índice da outra coordenada.
+    struct Line {
+        const int *idx;
+        const long long *val;
+        size_t len;
+    };
+
+    // A partir desta razão entre os tamanhos, a interseção usa galope.
+    static constexpr size_t GALLOP_RATIO = 16;
+
+    LazyProduct(const SparseMatrix &A, const SparseMatrix &B)
+        : rowsA(A, false), colsB(B, true), rowsB(B, false) {
+        if (A.n != B.n) throw std::runtime_error("Dimension mismatch in LazyProduct");
+    }
+
+    long long get(int i, int j) {
+        return dot(rowsA.line(i), colsB.line(j));
+    }
+
+    // Linha i de C, ordenada por coluna e sem zeros.
+    std::vector<std::pair<int,long long>> row(int i) {
+        Line a = rowsA.line(i);
+        std::vector<std::pair<int,long long>> acc;
+        for (size_t p = 0; p < a.len; ++p) {
+            Line b = rowsB.line(a.idx[p]);
+            long long av = a.val[p] % MOD;
+            for (size_t q = 0; q < b.len; ++q)
+                acc.push_back({b.idx[q], av * (b.val[q] % MOD) % MOD});
+        }
+        std::sort(acc.begin(), acc.end(),
+                  [](const std::pair<int,long long> &x, const std::pair<int,long long> &y){
+                      return x.first < y.first;
+                  });
+
+        size_t w = 0;
+        for (size_t r = 0; r < acc.size();) {
+            int j = acc[r].first;
+            long long sum = 0;
+            for (; r < acc.size() && acc[r].first == j; ++r) sum = (sum + acc[r].second) % MOD;
+            if (sum < 0) sum += MOD;
+            if (sum != 0LL) acc[w++] = {j, sum};
+        }
+        acc.resize(w);
+        return acc;
+    }
+
+    // C apenas nas posições pedidas, na mesma ordem.
+    std::vector<long long> masked(const std::vector<std::pair<int,int>> &pos) {
+        std::vector<long long> out(pos.size());
+        for (size_t p = 0; p < pos.size(); ++p)
+            out[p] = get(pos[p].first, pos[p].second);
+        return out;
+    }
+
+private:
+    // Linhas lógicas de uma matriz (ou colunas, se byColumn). Cada linha é
+    // extraída do map (data para linhas físicas, byCol para colunas físicas)
+    // na primeira consulta e guardada com o carimbo de versão da sua linha
+    // física; uma escrita só invalida as duas linhas que tocou.
+    class LineIndex {
+    public:
+        LineIndex(const SparseMatrix &M_, bool byColumn_)
+            : M(&M_), byColumn(byColumn_), core(nullptr), transposed(false) {}
+
+        Line line(int l) {
+            refresh();
+            const auto &stamp = physicalColumns ? core->colVersion : core->rowVersion;
+            auto it = cache.find(l);
+            if (it == cache.end()) it = cache.emplace(l, Cached()).first;
+            Cached &ln = it->second;
+            if (!ln.valid || ln.version != stamp[l]) {
+                fetch(l, ln);
+                ln.version = stamp[l];
+                ln.valid = true;
+            }
+            return {ln.idx.data(), ln.val.data(), ln.idx.size()};
+        }
+
+    private:
+        struct Cached {
+            bool valid = false;
+            uint64_t version = 0;
+            std::vector<int> idx;
+            std::vector<long long> val;
+        };
+
+        const SparseMatrix *M;
+        bool byColumn;
+        bool physicalColumns = false;
+
+        // Núcleo e orientação de M quando o cache foi preenchido.
+        SparseMatrix::Core *core;
+        bool transposed;
+
+        std::unordered_map<int, Cached> cache;
+
+        void refresh() {
+            if (core == M->core.get() && transposed == M->transposed) return;
+            core = M->core.get();
+            core->startTracking(M->n);
+            transposed = M->transposed;
+            physicalColumns = byColumn != transposed;
+            cache.clear();
+        }
+
+        void fetch(int l, Cached &ln) const {
+            const auto &src = physicalColumns ? core->byCol : core->data;
+            ln.idx.clear();
+            ln.val.clear();
+            auto it = src.lower_bound({l, INT_MIN});
+            for (; it != src.end() && it->first.first == l; ++it) {
+                ln.idx.push_back(it->first.second);
+                ln.val.push_back(it->second);
+            }
+        }
+    };
+
+    LineIndex rowsA, colsB, rowsB;
+
+    // Interseção ordenada; com tamanhos muito desiguais, busca exponencial
+    // (galope) na lista longa para cada índice da curta.
+    static long long dot(Line a, Line b) {
+        if (a.len > b.len) std::swap(a, b);
+        if (a.len == 0) return 0LL;
+
+        long long s = 0;
+        if (b.len / a.len >= GALLOP_RATIO) {
+            size_t lo = 0;
+            for (size_t p = 0; p < a.len && lo < b.len; ++p) {
+                int t = a.idx[p];
+                size_t hi = lo, step = 1;
+                while (hi < b.len && b.idx[hi] < t) {
+                    lo = hi + 1;
+                    hi += step;
+                    step <<= 1;
+                }
+                hi = std::min(hi + 1, b.len);
+                lo = std::lower_bound(b.idx + lo, b.idx + hi, t) - b.idx;
+                if (lo < b.len && b.idx[lo] == t)
+                    s = (s + (a.val[p] % MOD) * (b.val[lo] % MOD)) % MOD;
+            }
+        } else {
+            size_t p = 0, q = 0;
+            while (p < a.len && q < b.len) {
+                if (a.idx[p] < b.idx[q]) ++p;
+                else if (a.idx[p] > b.idx[q]) ++q;
+                else {
+                    s = (s + (a.val[p] % MOD) * (b.val[q] % MOD)) % MOD;
+                    ++p; ++q;
+                }
+            }
+        }
+        if (s < 0) s += MOD;
+        return s;
+    }
+};
+
+// Modo --verifica: as respostas das ops 7–9 são conferidas contra o produto
+// materializado por multiply(), refeito só depois de uma escrita ou
+// transposição. Retorna 2 na primeira divergência.
+struct ProductCheck {
+    const SparseMatrix &A, &B;
+    SparseMatrix C;
+    bool stale = true;
+
+    ProductCheck(const SparseMatrix &A_, const SparseMatrix &B_) : A(A_), B(B_) {}
+
+    const SparseMatrix &product() {
+        if (stale) { C = A.multiply(B); stale = false; }
+        return C;
+    }
+
+    bool entry(int i, int j, long long got) {
+        long long want = product().get(i, j);
+        if (got == want) return true;
+        std::cerr << "Divergência em (" << i << "," << j << "): " << got
+                  << " != " << want << "\n";
+        return false;
+    }
+
+    bool row(int i, const std::vector<std::pair<int,long long>> &got) {
+        const auto &data = product().core->data;
+        std::vector<std::pair<int,long long>> want;
+        for (auto it = data.lower_bound({i, INT_MIN}); it != data.end() && it->first.first == i; ++it)
+            want.push_back({it->first.second, it->second});
+        if (got == want) return true;
+        std::cerr << "Divergência na linha " << i << " do produto\n";
+        return false;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    bool verifica = argc > 1 && std::string(argv[1]) == "--verifica";
+
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 
@@ -194,6 +428,9 @@ int main() {
     int Q;
     if (!(std::cin >> Q)) return 0;
 
+    LazyProduct P(A, B);
+    ProductCheck check(A, B);
+
     while (Q--) {
         int op;
         if (!(std::cin >> op)) break;
@@ -212,12 +449,14 @@ int main() {
             std::cin >> m >> i >> j >> v;
             if (m == 1) A.set(i,j,v);
             else        B.set(i,j,v);
+            check.stale = true;
         }
         else if (op == 3) { // transpose
             int m;
             std::cin >> m;
             if (m == 1) A.toggleTranspose();
             else        B.toggleTranspose();
+            check.stale = true;
         }
         else if (op == 4) { // soma
             SparseMatrix C = A.add(B);
@@ -231,6 +470,28 @@ int main() {
         else if (op == 6) { // mult
             SparseMatrix C = A.multiply(B);
         }
+        else if (op == 7) { // entrada de A*B sob demanda
+            int i, j;
+            std::cin >> i >> j;
+            volatile long long res = P.get(i, j);
+            if (verifica && !check.entry(i, j, res)) return 2;
+        }
+        else if (op == 8) { // linha de A*B sob demanda
+            int i;
+            std::cin >> i;
+            auto linha = P.row(i);
+            if (verifica && !check.row(i, linha)) return 2;
+        }
+        else if (op == 9) { // A*B nas posições dadas
+            int q;
+            std::cin >> q;
+            std::vector<std::pair<int,int>> pos(q);
+            for (auto &p : pos) std::cin >> p.first >> p.second;
+            auto vals = P.masked(pos);
+            if (verifica)
+                for (int p = 0; p < q; ++p)
+                    if (!check.entry(pos[p].first, pos[p].second, vals[p])) return 2;
+        }
     }
     return 0;
 }
\ No newline at end of file
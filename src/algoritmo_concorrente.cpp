@@ -0,0 +1,632 @@
+#include <iostream>
+#include <vector>
+#include <tuple>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <unordered_map>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// Variante concorrente: várias threads leem (get, snapshot) enquanto uma única
+// thread escreve (set, addValue, transpose).
+// Estrutura: HAMT persistente (trie de hash com fanout 64). Cada escrita copia
+// apenas o caminho até a folha e publica a nova raiz com um store atômico;
+// leitores nunca bloqueiam. Os nós substituídos são liberados por reclamação
+// baseada em épocas (EBR) quando nenhum leitor pode mais alcançá-los.
+// Compilar com: g++ -O3 -std=c++17 -pthread algoritmo_concorrente.cpp
+// Uso: ./algoritmo_concorrente [leitores] < entrada
+
+const long long MOD = 1000000;
+
+// ---------------------------------------------------------------------------
+// Reclamação baseada em épocas
+// ---------------------------------------------------------------------------
+namespace ebr {
+
+const int MAX_THREADS = 256;
+
+struct alignas(64) Slot {
+    std::atomic<uint64_t> epoch{0};   // 0 = fora de seção crítica
+    std::atomic<bool> used{false};
+};
+
+inline std::atomic<uint64_t> globalEpoch{1};
+inline Slot registry[MAX_THREADS];
+
+// Registro da thread: reservado no primeiro uso, liberado ao fim da thread.
+struct Local {
+    int slot = -1;
+    int depth = 0;
+
+    Local() {
+        for (int s = 0; s < MAX_THREADS; ++s) {
+            bool livre = false;
+            if (registry[s].used.compare_exchange_strong(livre, true)) {
+                slot = s;
+                return;
+            }
+        }
+        throw std::runtime_error("EBR: threads demais");
+    }
+
+    ~Local() {
+        registry[slot].epoch.store(0);
+        registry[slot].used.store(false);
+    }
+};
+
+inline Local& local() {
+    thread_local Local l;
+    return l;
+}
+
+// Seção crítica de leitura: wait-free (um load e um store). Aninhável.
+class Guard {
+public:
+    Guard() : l(local()) {
+        if (l.depth++ == 0)
+            registry[l.slot].epoch.store(globalEpoch.load());
+    }
+    ~Guard() {
+        if (--l.depth == 0)
+            registry[l.slot].epoch.store(0);
+    }
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+private:
+    Local& l;
+};
+
+// Menor época entre leitores ativos (ou a global, se não há nenhum).
+// Tenta avançar a época global quando todos já observaram a atual.
+inline uint64_t advance() {
+    uint64_t g = globalEpoch.load();
+    uint64_t menor = g;
+    for (int s = 0; s < MAX_THREADS; ++s) {
+        uint64_t e = registry[s].epoch.load();
+        if (e != 0 && e < menor) menor = e;
+    }
+    if (menor == g) globalEpoch.compare_exchange_strong(g, g + 1);
+    return menor;
+}
+
+} // namespace ebr
+
+// ---------------------------------------------------------------------------
+// Matriz
+// ---------------------------------------------------------------------------
+class SparseMatrix {
+public:
+    struct Node;
+
+    struct Slot {
+        uint64_t key;
+        union {
+            long long val;
+            Node* child;
+        };
+    };
+
+    // Nó imutável após publicado: bitmap dos índices ocupados, leafmap dos
+    // que são folhas (os demais apontam para filhos), slots compactados.
+    struct Node {
+        uint64_t bitmap;
+        uint64_t leafmap;
+        Slot* slots() { return reinterpret_cast<Slot*>(this + 1); }
+        int count() const { return __builtin_popcountll(bitmap); }
+    };
+
+    struct Entry {
+        uint64_t h;
+        uint64_t key;
+        long long val;
+    };
+
+    // Nós retirados acumulados antes de tentar liberar.
+    static constexpr size_t RECLAIM_BATCH = 4096;
+
+    int n;
+
+    explicit SparseMatrix(int n_ = 0) : n(n_), head(0) {}
+
+    SparseMatrix(int n_, const std::vector<std::tuple<int,int,long long>>& elems)
+        : n(n_), head(0) {
+        std::vector<Entry> es;
+        es.reserve(elems.size());
+        for (auto &t : elems) {
+            int i, j; long long v;
+            std::tie(i,j,v) = t;
+            uint64_t key = packKey(i, j);
+            es.push_back({mix(key), key, v});
+        }
+        head.store(encode(buildFrom(es), false));
+    }
+
+    SparseMatrix(SparseMatrix&& o) noexcept
+        : n(o.n), head(o.head.load()), retired(std::move(o.retired)) {
+        o.head.store(0);
+    }
+
+    SparseMatrix(const SparseMatrix&) = delete;
+    SparseMatrix& operator=(const SparseMatrix&) = delete;
+
+    // Só pode ser destruída quando nenhuma outra thread a acessa.
+    ~SparseMatrix() {
+        freeTree(root(head.load()));
+        for (auto &r : retired) std::free(r.second);
+    }
+
+    // Versão consistente (raiz + flag de transposição) mantida viva enquanto
+    // o snapshot existir; escritas concorrentes não a afetam.
+    class Snapshot {
+    public:
+        explicit Snapshot(const SparseMatrix& M)
+            : n(M.n) {
+            uintptr_t h = M.head.load();
+            rootNode = root(h);
+            transposed = isTransposed(h);
+        }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        long long get(int i, int j) const {
+            return lookup(rootNode, transposed ? packKey(j, i) : packKey(i, j));
+        }
+
+        template<class Func>
+        void forEachNonZero(Func f) const {
+            auto visita = [&](uint64_t key, long long v){
+                int bi = (int)(key >> 32), bj = (int)(uint32_t)key;
+                if (transposed) f(bj, bi, v);
+                else            f(bi, bj, v);
+            };
+            walk(rootNode, visita);
+        }
+
+        int n;
+
+    private:
+        ebr::Guard guard;   // declarado antes da raiz: entra na época antes do load
+        Node* rootNode;
+        bool transposed;
+    };
+
+    Snapshot snapshot() const {
+        return Snapshot(*this);
+    }
+
+    // Leitura wait-free: sem locks nem CAS.
+    long long get(int i, int j) const {
+        ebr::Guard g;
+        uintptr_t h = head.load();
+        uint64_t key = isTransposed(h) ? packKey(j, i) : packKey(i, j);
+        return lookup(root(h), key);
+    }
+
+    // --- Escritor único ---
+
+    void set(int i, int j, long long v) {
+        uintptr_t h = head.load();
+        uint64_t key = isTransposed(h) ? packKey(j, i) : packKey(i, j);
+        uint64_t hk = mix(key);
+        Node* r = root(h);
+
+        std::vector<Node*> old;
+        Node* nr;
+        if (v == 0LL) {
+            bool changed = false;
+            nr = eraseRec(r, hk, key, 0, old, changed);
+            if (!changed) return;
+        } else {
+            nr = r ? insertRec(r, hk, key, v, 0, old) : leafNode(hk, key, v, 0);
+        }
+        publish(encode(nr, isTransposed(h)), old);
+    }
+
+    void addValue(int i, int j, long long delta) {
+        if (delta == 0LL) return;
+        set(i, j, get(i, j) + delta);
+    }
+
+    void transpose() {
+        uintptr_t h = head.load();
+        head.store(h ^ 1);
+    }
+
+    // Soma e multiplicação leem snapshots: rodam enquanto outra thread escreve.
+    SparseMatrix add(const SparseMatrix &B) const {
+        if (n != B.n) throw std::runtime_error("Dimension mismatch in add");
+        Snapshot sa = snapshot(), sb = B.snapshot();
+        std::unordered_map<uint64_t, long long> acc;
+        acc.reserve(1024);
+        auto soma = [&](int i, int j, long long v){ acc[packKey(i, j)] += v % MOD; };
+        sa.forEachNonZero(soma);
+        sb.forEachNonZero(soma);
+        return fromAccumulator(n, acc);
+    }
+
+    SparseMatrix scale(long long alpha) const {
+        Snapshot s = snapshot();
+        std::unordered_map<uint64_t, long long> acc;
+        if (alpha != 0LL) {
+            s.forEachNonZero([&](int i, int j, long long v){
+                acc[packKey(i, j)] = (v % MOD) * (alpha % MOD);
+            });
+        }
+        return fromAccumulator(n, acc);
+    }
+
+    SparseMatrix multiply(const SparseMatrix &B) const {
+        if (n != B.n) throw std::runtime_error("Dimension mismatch in multiply");
+        Snapshot sa = snapshot(), sb = B.snapshot();
+
+        std::vector<std::vector<std::pair<int,long long>>> rowB(n);
+        sb.forEachNonZero([&](int r, int c, long long val){
+            rowB[r].push_back({c, val});
+        });
+
+        std::unordered_map<uint64_t, long long> acc;
+        sa.forEachNonZero([&](int i, int k, long long a_val){
+            for (auto &par : rowB[k]) {
+                long long prod = (a_val % MOD) * (par.second % MOD);
+                long long &c = acc[packKey(i, par.first)];
+                c = (c + prod) % MOD;
+            }
+        });
+        return fromAccumulator(n, acc);
+    }
+
+private:
+    // Bit 0 da cabeça guarda a flag de transposição: raiz e flag são
+    // publicadas juntas num único store.
+    std::atomic<uintptr_t> head;
+    std::vector<std::pair<uint64_t, Node*>> retired;
+
+    static uint64_t packKey(int i, int j) {
+        return ((uint64_t)(uint32_t)i << 32) | (uint32_t)j;
+    }
+
+    // Finalizador do splitmix64: bijetivo, então chaves distintas nunca
+    // colidem no hash completo e a trie dispensa listas de colisão.
+    static uint64_t mix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // Níveis 0..9 consomem 6 bits cada, do mais significativo; o nível 10
+    // usa os 4 bits restantes.
+    static int slotIndex(uint64_t h, int level) {
+        int shift = 58 - 6 * level;
+        return shift >= 0 ? (int)((h >> shift) & 63) : (int)(h & 15);
+    }
+
+    static Node* root(uintptr_t h) { return reinterpret_cast<Node*>(h & ~(uintptr_t)1); }
+    static bool isTransposed(uintptr_t h) { return h & 1; }
+    static uintptr_t encode(Node* r, bool t) { return reinterpret_cast<uintptr_t>(r) | (t ? 1 : 0); }
+
+    static Node* allocNode(int count, uint64_t bitmap, uint64_t leafmap) {
+        Node* nd = static_cast<Node*>(std::malloc(sizeof(Node) + sizeof(Slot) * std::max(count, 1)));
+        nd->bitmap = bitmap;
+        nd->leafmap = leafmap;
+        return nd;
+    }
+
+    static long long lookup(Node* nd, uint64_t key) {
+        uint64_t h = mix(key);
+        for (int level = 0; nd; ++level) {
+            uint64_t bit = 1ULL << slotIndex(h, level);
+            if (!(nd->bitmap & bit)) return 0LL;
+            const Slot &s = nd->slots()[__builtin_popcountll(nd->bitmap & (bit - 1))];
+            if (nd->leafmap & bit) return s.key == key ? s.val : 0LL;
+            nd = s.child;
+        }
+        return 0LL;
+    }
+
+    template<class Func>
+    static void walk(Node* nd, Func &f) {
+        if (!nd) return;
+        Slot* s = nd->slots();
+        int c = nd->count();
+        uint64_t bits = nd->bitmap;
+        for (int p = 0; p < c; ++p) {
+            uint64_t bit = bits & (~bits + 1);
+            bits ^= bit;
+            if (nd->leafmap & bit) f(s[p].key, s[p].val);
+            else                   walk(s[p].child, f);
+        }
+    }
+
+    static void freeTree(Node* nd) {
+        if (!nd) return;
+        Slot* s = nd->slots();
+        int c = nd->count();
+        uint64_t bits = nd->bitmap;
+        for (int p = 0; p < c; ++p) {
+            uint64_t bit = bits & (~bits + 1);
+            bits ^= bit;
+            if (!(nd->leafmap & bit)) freeTree(s[p].child);
+        }
+        std::free(nd);
+    }
+
+    // --- Construção em lote (sem leitores: monta a trie diretamente) ---
+
+    // Ordenadas por hash, as entradas de cada filho ficam contíguas, pois os
+    // níveis consomem o hash do bit mais significativo para o menos.
+    static Node* buildRec(const Entry* b, const Entry* e, int level) {
+        uint64_t bitmap = 0, leafmap = 0;
+        for (const Entry* p = b; p != e;) {
+            int idx = slotIndex(p->h, level);
+            const Entry* q = p;
+            while (q != e && slotIndex(q->h, level) == idx) ++q;
+            bitmap |= 1ULL << idx;
+            if (q - p == 1) leafmap |= 1ULL << idx;
+            p = q;
+        }
+
+        Node* nd = allocNode(__builtin_popcountll(bitmap), bitmap, leafmap);
+        Slot* s = nd->slots();
+        for (const Entry* p = b; p != e; ++s) {
+            int idx = slotIndex(p->h, level);
+            const Entry* q = p;
+            while (q != e && slotIndex(q->h, level) == idx) ++q;
+            if (q - p == 1) { s->key = p->key; s->val = p->val; }
+            else            { s->key = 0; s->child = buildRec(p, q, level + 1); }
+            p = q;
+        }
+        return nd;
+    }
+
+    // Repetições da mesma posição: vale a última (como set em sequência).
+    static Node* buildFrom(std::vector<Entry>& es) {
+        std::stable_sort(es.begin(), es.end(),
+                         [](const Entry& a, const Entry& b){ return a.h < b.h; });
+        size_t w = 0;
+        for (size_t r = 0; r < es.size(); ++r) {
+            if (r + 1 < es.size() && es[r + 1].h == es[r].h) continue;
+            if (es[r].val != 0LL) es[w++] = es[r];
+        }
+        es.resize(w);
+        return es.empty() ? nullptr : buildRec(es.data(), es.data() + es.size(), 0);
+    }
+
+    static SparseMatrix fromAccumulator(int n, const std::unordered_map<uint64_t, long long>& acc) {
+        std::vector<Entry> es;
+        es.reserve(acc.size());
+        for (auto &kv : acc) {
+            long long val = kv.second % MOD;
+            if (val < 0) val += MOD;
+            if (val != 0LL) es.push_back({mix(kv.first), kv.first, val});
+        }
+        SparseMatrix C(n);
+        C.head.store(encode(buildFrom(es), false));
+        return C;
+    }
+
+    // --- Escrita persistente (cópia de caminho) ---
+
+    static Node* leafNode(uint64_t h, uint64_t key, long long v, int level) {
+        uint64_t bit = 1ULL << slotIndex(h, level);
+        Node* nd = allocNode(1, bit, bit);
+        nd->slots()[0].key = key;
+        nd->slots()[0].val = v;
+        return nd;
+    }
+
+    // Nó com duas folhas cujos hashes coincidem até 'level'.
+    static Node* pairNode(const Slot& a, uint64_t ha, uint64_t kb, long long vb, uint64_t hb, int level) {
+        int ia = slotIndex(ha, level), ib = slotIndex(hb, level);
+        if (ia == ib) {
+            Node* nd = allocNode(1, 1ULL << ia, 0);
+            nd->slots()[0].key = 0;
+            nd->slots()[0].child = pairNode(a, ha, kb, vb, hb, level + 1);
+            return nd;
+        }
+        uint64_t bits = (1ULL << ia) | (1ULL << ib);
+        Node* nd = allocNode(2, bits, bits);
+        Slot b; b.key = kb; b.val = vb;
+        nd->slots()[ia < ib ? 0 : 1] = a;
+        nd->slots()[ia < ib ? 1 : 0] = b;
+        return nd;
+    }
+
+    static Node* copyNode(Node* nd) {
+        int c = nd->count();
+        Node* cp = allocNode(c, nd->bitmap, nd->leafmap);
+        std::memcpy(cp->slots(), nd->slots(), sizeof(Slot) * c);
+        return cp;
+    }
+
+    static Node* insertRec(Node* nd, uint64_t h, uint64_t key, long long v, int level,
+                           std::vector<Node*>& old) {
+        uint64_t bit = 1ULL << slotIndex(h, level);
+        int pos = __builtin_popcountll(nd->bitmap & (bit - 1));
+        int c = nd->count();
+        old.push_back(nd);
+
+        if (!(nd->bitmap & bit)) {
+            Node* cp = allocNode(c + 1, nd->bitmap | bit, nd->leafmap | bit);
+            std::memcpy(cp->slots(), nd->slots(), sizeof(Slot) * pos);
+            std::memcpy(cp->slots() + pos + 1, nd->slots() + pos, sizeof(Slot) * (c - pos));
+            cp->slots()[pos].key = key;
+            cp->slots()[pos].val = v;
+            return cp;
+        }
+
+        Node* cp = copyNode(nd);
+        Slot &s = cp->slots()[pos];
+        if (nd->leafmap & bit) {
+            if (s.key == key) {
+                s.val = v;
+            } else {
+                Node* child = pairNode(s, mix(s.key), key, v, h, level + 1);
+                s.key = 0;
+                s.child = child;
+                cp->leafmap &= ~bit;
+            }
+        } else {
+            s.child = insertRec(s.child, h, key, v, level + 1, old);
+        }
+        return cp;
+    }
+
+    // Retorna o novo nó (nullptr se ficou vazio). Filho reduzido a uma única
+    // folha é absorvido pelo pai para manter a trie rasa.
+    static Node* eraseRec(Node* nd, uint64_t h, uint64_t key, int level,
+                          std::vector<Node*>& old, bool& changed) {
+        if (!nd) return nd;
+        uint64_t bit = 1ULL << slotIndex(h, level);
+        if (!(nd->bitmap & bit)) return nd;
+        int pos = __builtin_popcountll(nd->bitmap & (bit - 1));
+        int c = nd->count();
+
+        Node* child = nullptr;
+        bool inlineLeaf = false;
+        Slot leaf{};
+        if (nd->leafmap & bit) {
+            if (nd->slots()[pos].key != key) return nd;
+        } else {
+            child = eraseRec(nd->slots()[pos].child, h, key, level + 1, old, changed);
+            if (!changed) return nd;
+            if (child && child->count() == 1 && child->leafmap) {
+                // Nó recém-criado e ainda não publicado: pode ser liberado já.
+                leaf = child->slots()[0];
+                std::free(child);
+                child = nullptr;
+                inlineLeaf = true;
+            }
+        }
+        changed = true;
+        old.push_back(nd);
+
+        if (child || inlineLeaf) {
+            Node* cp = copyNode(nd);
+            if (inlineLeaf) {
+                cp->slots()[pos] = leaf;
+                cp->leafmap |= bit;
+            } else {
+                cp->slots()[pos].child = child;
+            }
+            return cp;
+        }
+
+        if (c == 1) return nullptr;
+        Node* cp = allocNode(c - 1, nd->bitmap & ~bit, nd->leafmap & ~bit);
+        std::memcpy(cp->slots(), nd->slots(), sizeof(Slot) * pos);
+        std::memcpy(cp->slots() + pos, nd->slots() + pos + 1, sizeof(Slot) * (c - pos - 1));
+        return cp;
+    }
+
+    // Publica a nova versão e retira os nós do caminho antigo. Um nó retirado
+    // na época e só é liberado quando todo leitor ativo entrou depois de e.
+    void publish(uintptr_t h, const std::vector<Node*>& old) {
+        head.store(h);
+        uint64_t e = ebr::globalEpoch.load();
+        for (Node* nd : old) retired.push_back({e, nd});
+        if (retired.size() < RECLAIM_BATCH) return;
+
+        uint64_t menor = ebr::advance();
+        size_t w = 0;
+        for (auto &r : retired) {
+            if (r.first < menor) std::free(r.second);
+            else retired[w++] = r;
+        }
+        retired.resize(w);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    unsigned leitores = argc > 1 ? (unsigned)std::stoul(argv[1]) : std::thread::hardware_concurrency();
+    leitores = std::max(1u, std::min(leitores, (unsigned)ebr::MAX_THREADS - 1));
+
+    int k1, N1;
+    if (!(std::cin >> k1 >> N1)) return 0;
+    std::vector<std::tuple<int,int,long long>> elems1;
+    elems1.reserve(k1);
+    for (int t = 0; t < k1; ++t) {
+        int i, j; long long v;
+        std::cin >> i >> j >> v;
+        elems1.emplace_back(i, j, v);
+    }
+    SparseMatrix A(N1, elems1);
+
+    int k2, N2;
+    std::cin >> k2 >> N2;
+    std::vector<std::tuple<int,int,long long>> elems2;
+    elems2.reserve(k2);
+    for (int t = 0; t < k2; ++t) {
+        int i, j; long long v;
+        std::cin >> i >> j >> v;
+        elems2.emplace_back(i, j, v);
+    }
+    SparseMatrix B(N2, elems2);
+
+    if (N1 != N2) return 1;
+
+    int Q;
+    if (!(std::cin >> Q)) return 0;
+
+    struct Op { int op, m, i, j; long long v; };
+    std::vector<Op> ops;
+    std::vector<int> consultas;
+    ops.reserve(Q);
+    while (Q--) {
+        Op o{0, 0, 0, 0, 0};
+        if (!(std::cin >> o.op)) break;
+        if (o.op == 1)      std::cin >> o.m >> o.i >> o.j;
+        else if (o.op == 2) std::cin >> o.m >> o.i >> o.j >> o.v;
+        else if (o.op == 3) std::cin >> o.m;
+        else if (o.op == 5) std::cin >> o.m >> o.v;
+        if (o.op == 1) consultas.push_back((int)ops.size());
+        ops.push_back(o);
+    }
+
+    // Consultas (op 1) divididas entre as threads leitoras; as demais
+    // operações são aplicadas em ordem pela thread principal, ao mesmo tempo.
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < leitores && t < consultas.size(); ++t) {
+        pool.emplace_back([&, t]{
+            for (size_t q = t; q < consultas.size(); q += leitores) {
+                const Op &o = ops[consultas[q]];
+                volatile long long res;
+                if (o.m == 1) res = A.get(o.i, o.j);
+                else          res = B.get(o.i, o.j);
+                (void)res;
+            }
+        });
+    }
+
+    for (const Op &o : ops) {
+        if (o.op == 2) { // set
+            if (o.m == 1) A.set(o.i, o.j, o.v);
+            else          B.set(o.i, o.j, o.v);
+        }
+        else if (o.op == 3) { // transpose
+            if (o.m == 1) A.transpose();
+            else          B.transpose();
+        }
+        else if (o.op == 4) { // soma
+            SparseMatrix C = A.add(B);
+        }
+        else if (o.op == 5) { // scale
+            if (o.m == 1) { SparseMatrix C = A.scale(o.v); }
+            else          { SparseMatrix C = B.scale(o.v); }
+        }
+        else if (o.op == 6) { // mult
+            SparseMatrix C = A.multiply(B);
+        }
+    }
+
+    for (auto &t : pool) t.join();
+    return 0;
+}
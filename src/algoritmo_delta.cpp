@@ -0,0 +1,459 @@
+#include <iostream>
+#include <vector>
+#include <tuple>
+#include <memory>
+#include <future>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+// Variante otimizada para escrita: base compactada em CSR (linhas físicas
+// ordenadas) e atualizações acumuladas num buffer de duas camadas:
+//   L0 - tabela hash pequena (absorve o set em O(1));
+//   L1 - run ordenado, recebe L0 ordenado quando ele enche.
+// Quando L1 passa do limite é congelado e intercalado com a base numa thread
+// de fundo; soma/escala/multiplicação compactam tudo antes de ler a base.
+// Remoções (v=0) viram marcas com valor 0 até a intercalação.
+// Compilar com: g++ -O3 -std=c++17 -pthread algoritmo_delta.cpp
+// Prints removidos para benchmark.
+
+const long long MOD = 1000000;
+
+class SparseMatrix {
+public:
+    struct Entry {
+        uint64_t key;   // (linha física << 32) | coluna física
+        long long val;
+    };
+
+    struct Csr {
+        std::vector<size_t> ptr;    // n+1
+        std::vector<int> col;
+        std::vector<long long> val;
+        size_t nnz() const { return col.size(); }
+    };
+
+    // L0: 2^L0_BITS posições, no máximo metade ocupada.
+    static constexpr int L0_BITS = 14;
+    static constexpr size_t L0_SLOTS = size_t(1) << L0_BITS;
+    static constexpr size_t L0_CAP = L0_SLOTS / 2;
+    static constexpr uint64_t EMPTY = ~0ULL;
+    static constexpr size_t L1_MIN = 4096;
+
+    int n;
+    bool transposed;
+
+    explicit SparseMatrix(int n_ = 0)
+        : n(n_), transposed(false),
+          base(std::make_shared<const Csr>(fromSorted(n_, {}))) {}
+
+    SparseMatrix(int n_, const std::vector<std::tuple<int,int,long long>>& elems)
+        : n(n_), transposed(false) {
+        std::vector<Entry> es;
+        es.reserve(elems.size());
+        for (auto &t : elems) {
+            int i, j; long long v;
+            std::tie(i,j,v) = t;
+            es.push_back({packKey(i, j), v});
+        }
+        // Repetições da mesma posição: vale a última.
+        std::stable_sort(es.begin(), es.end(),
+                         [](const Entry& a, const Entry& b){ return a.key < b.key; });
+        size_t w = 0;
+        for (size_t r = 0; r < es.size(); ++r) {
+            if (r + 1 < es.size() && es[r + 1].key == es[r].key) continue;
+            if (es[r].val != 0LL) es[w++] = es[r];
+        }
+        es.resize(w);
+        base = std::make_shared<const Csr>(fromSorted(n, es));
+    }
+
+    long long get(int i, int j) const {
+        uint64_t key = mapKey(i, j);
+
+        // Camadas da mais nova para a mais antiga; a primeira que tem a
+        // posição decide (valor 0 = removido).
+        const Entry* e = findL0(key);
+        if (e) return e->val;
+        if (findSorted(l1, key, e)) return e->val;
+        if (frozen && findSorted(*frozen, key, e)) return e->val;
+
+        int r = (int)(key >> 32), c = (int)(uint32_t)key;
+        const Csr &b = *base;
+        auto first = b.col.begin() + b.ptr[r], last = b.col.begin() + b.ptr[r + 1];
+        auto it = std::lower_bound(first, last, c);
+        if (it == last || *it != c) return 0LL;
+        return b.val[it - b.col.begin()];
+    }
+
+    void set(int i, int j, long long v) {
+        uint64_t key = mapKey(i, j);
+        if (l0.empty()) l0.assign(L0_SLOTS, Entry{EMPTY, 0});
+        size_t s = slotOf(key);
+        while (l0[s].key != EMPTY && l0[s].key != key) s = (s + 1) & (L0_SLOTS - 1);
+        if (l0[s].key == EMPTY) {
+            l0[s].key = key;
+            ++l0Count;
+        }
+        l0[s].val = v;
+        if (l0Count == L0_CAP) flushL0();
+    }
+
+    void addValue(int i, int j, long long delta) {
+        if (delta == 0LL) return;
+        set(i, j, get(i, j) + delta);
+    }
+
+    void toggleTranspose() {
+        transposed = !transposed;
+    }
+
+    // Intercala todos os buffers na base (espera a intercalação de fundo).
+    void compact() const {
+        flushL0();
+        waitMerge();
+        if (!l1.empty()) {
+            base = std::make_shared<const Csr>(mergeInto(n, *base, l1));
+            l1.clear();
+        }
+    }
+
+    template<class Func>
+    void forEachNonZero(Func f) const {
+        compact();
+        const Csr &b = *base;
+        for (int r = 0; r < n; ++r) {
+            for (size_t p = b.ptr[r]; p < b.ptr[r + 1]; ++p) {
+                if (!transposed) f(r, b.col[p], b.val[p]);
+                else             f(b.col[p], r, b.val[p]);
+            }
+        }
+    }
+
+    SparseMatrix add(const SparseMatrix &B) const {
+        if (n != B.n) throw std::runtime_error("Dimension mismatch in add");
+        compact();
+        B.compact();
+
+        // Soma na orientação física de A; B é transposta se necessário.
+        Csr bt;
+        const Csr &a = *base;
+        const Csr &b = transposed == B.transposed ? *B.base : (bt = transposeCsr(n, *B.base));
+
+        Csr c;
+        c.ptr.assign(n + 1, 0);
+        c.col.reserve(a.nnz() + b.nnz());
+        c.val.reserve(a.nnz() + b.nnz());
+        auto emite = [&](int col, long long v){
+            v %= MOD;
+            if (v < 0) v += MOD;
+            if (v != 0LL) { c.col.push_back(col); c.val.push_back(v); }
+        };
+        for (int r = 0; r < n; ++r) {
+            size_t p = a.ptr[r], pe = a.ptr[r + 1];
+            size_t q = b.ptr[r], qe = b.ptr[r + 1];
+            while (p < pe || q < qe) {
+                if (q == qe || (p < pe && a.col[p] < b.col[q])) { emite(a.col[p], a.val[p] % MOD); ++p; }
+                else if (p == pe || b.col[q] < a.col[p])        { emite(b.col[q], b.val[q] % MOD); ++q; }
+                else { emite(a.col[p], a.val[p] % MOD + b.val[q] % MOD); ++p; ++q; }
+            }
+            c.ptr[r + 1] = c.col.size();
+        }
+        return SparseMatrix(n, transposed, std::move(c));
+    }
+
+    SparseMatrix scale(long long alpha) const {
+        compact();
+        const Csr &a = *base;
+        Csr c;
+        c.ptr.assign(n + 1, 0);
+        if (alpha != 0LL) {
+            c.col.reserve(a.nnz());
+            c.val.reserve(a.nnz());
+            for (int r = 0; r < n; ++r) {
+                for (size_t p = a.ptr[r]; p < a.ptr[r + 1]; ++p) {
+                    long long nv = (a.val[p] % MOD) * (alpha % MOD);
+                    nv %= MOD;
+                    if (nv < 0) nv += MOD;
+                    if (nv != 0LL) { c.col.push_back(a.col[p]); c.val.push_back(nv); }
+                }
+                c.ptr[r + 1] = c.col.size();
+            }
+        }
+        return SparseMatrix(n, transposed, std::move(c));
+    }
+
+    // Gustavson linha a linha com acumulador denso (SPA) de tamanho n.
+    SparseMatrix multiply(const SparseMatrix &B) const {
+        if (n != B.n) throw std::runtime_error("Dimension mismatch in multiply");
+        compact();
+        B.compact();
+
+        Csr at, bt;
+        const Csr &a = transposed ? (at = transposeCsr(n, *base)) : *base;
+        const Csr &b = B.transposed ? (bt = transposeCsr(n, *B.base)) : *B.base;
+
+        Csr c;
+        c.ptr.assign(n + 1, 0);
+        std::vector<long long> acc(n, 0);
+        std::vector<int> mark(n, -1);
+        std::vector<int> tocadas;
+
+        for (int i = 0; i < n; ++i) {
+            tocadas.clear();
+            for (size_t p = a.ptr[i]; p < a.ptr[i + 1]; ++p) {
+                int k = a.col[p];
+                long long a_val = a.val[p] % MOD;
+                for (size_t q = b.ptr[k]; q < b.ptr[k + 1]; ++q) {
+                    int j = b.col[q];
+                    if (mark[j] != i) {
+                        mark[j] = i;
+                        acc[j] = 0;
+                        tocadas.push_back(j);
+                    }
+                    acc[j] = (acc[j] + a_val * (b.val[q] % MOD)) % MOD;
+                }
+            }
+            std::sort(tocadas.begin(), tocadas.end());
+            for (int j : tocadas) {
+                long long v = acc[j];
+                if (v < 0) v += MOD;
+                if (v != 0LL) { c.col.push_back(j); c.val.push_back(v); }
+            }
+            c.ptr[i + 1] = c.col.size();
+        }
+        return SparseMatrix(n, false, std::move(c));
+    }
+
+private:
+    // Buffers e base mudam em compact(), que preserva o conteúdo lógico.
+    mutable std::shared_ptr<const Csr> base;
+    mutable std::vector<Entry> l0;      // vazio até o primeiro set: sem L0
+    mutable size_t l0Count = 0;
+    mutable std::vector<Entry> l1;
+    mutable std::shared_ptr<const std::vector<Entry>> frozen;
+    mutable std::future<std::shared_ptr<const Csr>> pending;
+
+    SparseMatrix(int n_, bool t, Csr&& c)
+        : n(n_), transposed(t),
+          base(std::make_shared<const Csr>(std::move(c))) {}
+
+    static uint64_t packKey(int i, int j) {
+        return ((uint64_t)(uint32_t)i << 32) | (uint32_t)j;
+    }
+
+    uint64_t mapKey(int i, int j) const {
+        return transposed ? packKey(j, i) : packKey(i, j);
+    }
+
+    static size_t slotOf(uint64_t key) {
+        return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> (64 - L0_BITS));
+    }
+
+    const Entry* findL0(uint64_t key) const {
+        if (l0.empty()) return nullptr;
+        size_t s = slotOf(key);
+        while (l0[s].key != EMPTY) {
+            if (l0[s].key == key) return &l0[s];
+            s = (s + 1) & (L0_SLOTS - 1);
+        }
+        return nullptr;
+    }
+
+    static bool findSorted(const std::vector<Entry>& v, uint64_t key, const Entry*& out) {
+        auto it = std::lower_bound(v.begin(), v.end(), key,
+                                   [](const Entry& e, uint64_t k){ return e.key < k; });
+        if (it == v.end() || it->key != key) return false;
+        out = &*it;
+        return true;
+    }
+
+    // Limite de L1 que equilibra o custo amortizado de intercalar L0 em L1
+    // (|L1| / L0_CAP por set) e L1 na base ((nnz + n) / |L1| por set).
+    size_t l1Cap() const {
+        double alvo = std::sqrt((double)L0_CAP * (double)(base->nnz() + (size_t)n));
+        return std::max(L1_MIN, (size_t)alvo);
+    }
+
+    // Ordena L0 e intercala em L1 (L0 é mais novo e prevalece).
+    void flushL0() const {
+        if (l0.empty() || l0Count == 0) return;
+        std::vector<Entry> novos;
+        novos.reserve(l0Count);
+        for (auto &e : l0) {
+            if (e.key != EMPTY) novos.push_back(e);
+            e.key = EMPTY;
+        }
+        l0Count = 0;
+        std::sort(novos.begin(), novos.end(),
+                  [](const Entry& a, const Entry& b){ return a.key < b.key; });
+
+        std::vector<Entry> merged;
+        merged.reserve(l1.size() + novos.size());
+        size_t p = 0, q = 0;
+        while (p < l1.size() || q < novos.size()) {
+            if (q == novos.size() || (p < l1.size() && l1[p].key < novos[q].key)) merged.push_back(l1[p++]);
+            else {
+                if (p < l1.size() && l1[p].key == novos[q].key) ++p;
+                merged.push_back(novos[q++]);
+            }
+        }
+        l1.swap(merged);
+
+        pollMerge();
+        if (l1.size() >= l1Cap()) startMerge();
+    }
+
+    // Congela L1 e intercala com a base numa thread de fundo. Base e L1
+    // congelado são imutáveis enquanto isso; leituras continuam usando ambos.
+    void startMerge() const {
+        waitMerge();
+        frozen = std::make_shared<const std::vector<Entry>>(std::move(l1));
+        l1.clear();
+        int nn = n;
+        std::shared_ptr<const Csr> b = base;
+        std::shared_ptr<const std::vector<Entry>> f = frozen;
+        pending = std::async(std::launch::async, [nn, b, f]{
+            return std::make_shared<const Csr>(mergeInto(nn, *b, *f));
+        });
+    }
+
+    void pollMerge() const {
+        if (pending.valid() &&
+            pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            waitMerge();
+    }
+
+    void waitMerge() const {
+        if (!pending.valid()) return;
+        base = pending.get();
+        frozen.reset();
+    }
+
+    static Csr fromSorted(int n, const std::vector<Entry>& es) {
+        return mergeInto(n, Csr{std::vector<size_t>(n + 1, 0), {}, {}}, es);
+    }
+
+    // Base + delta ordenado (delta prevalece; valor 0 remove).
+    static Csr mergeInto(int n, const Csr& b, const std::vector<Entry>& delta) {
+        Csr c;
+        c.ptr.assign(n + 1, 0);
+        c.col.reserve(b.nnz() + delta.size());
+        c.val.reserve(b.nnz() + delta.size());
+        size_t d = 0;
+        for (int r = 0; r < n; ++r) {
+            size_t p = b.ptr[r], pe = b.ptr[r + 1];
+            while (p < pe || (d < delta.size() && (int)(delta[d].key >> 32) == r)) {
+                bool temDelta = d < delta.size() && (int)(delta[d].key >> 32) == r;
+                int dc = temDelta ? (int)(uint32_t)delta[d].key : 0;
+                if (!temDelta || (p < pe && b.col[p] < dc)) {
+                    c.col.push_back(b.col[p]);
+                    c.val.push_back(b.val[p]);
+                    ++p;
+                } else {
+                    if (p < pe && b.col[p] == dc) ++p;
+                    if (delta[d].val != 0LL) {
+                        c.col.push_back(dc);
+                        c.val.push_back(delta[d].val);
+                    }
+                    ++d;
+                }
+            }
+            c.ptr[r + 1] = c.col.size();
+        }
+        return c;
+    }
+
+    // Transposta física por contagem: O(n + nnz), colunas já saem ordenadas.
+    static Csr transposeCsr(int n, const Csr& a) {
+        Csr t;
+        t.ptr.assign(n + 1, 0);
+        for (int c : a.col) ++t.ptr[c + 1];
+        for (int r = 0; r < n; ++r) t.ptr[r + 1] += t.ptr[r];
+        t.col.resize(a.nnz());
+        t.val.resize(a.nnz());
+        std::vector<size_t> pos(t.ptr.begin(), t.ptr.end() - 1);
+        for (int r = 0; r < n; ++r) {
+            for (size_t p = a.ptr[r]; p < a.ptr[r + 1]; ++p) {
+                size_t dst = pos[a.col[p]]++;
+                t.col[dst] = r;
+                t.val[dst] = a.val[p];
+            }
+        }
+        return t;
+    }
+};
+
+int main() {
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    int k1, N1;
+    if (!(std::cin >> k1 >> N1)) return 0;
+    std::vector<std::tuple<int,int,long long>> elems1;
+    elems1.reserve(k1);
+    for (int t = 0; t < k1; ++t) {
+        int i, j; long long v;
+        std::cin >> i >> j >> v;
+        elems1.emplace_back(i, j, v);
+    }
+    SparseMatrix A(N1, elems1);
+
+    int k2, N2;
+    std::cin >> k2 >> N2;
+    std::vector<std::tuple<int,int,long long>> elems2;
+    elems2.reserve(k2);
+    for (int t = 0; t < k2; ++t) {
+        int i, j; long long v;
+        std::cin >> i >> j >> v;
+        elems2.emplace_back(i, j, v);
+    }
+    SparseMatrix B(N2, elems2);
+
+    if (N1 != N2) return 1;
+
+    int Q;
+    if (!(std::cin >> Q)) return 0;
+
+    while (Q--) {
+        int op;
+        if (!(std::cin >> op)) break;
+
+        if (op == 1) { // consulta
+            int m, i, j;
+            std::cin >> m >> i >> j;
+            volatile long long res;
+            if (m == 1) res = A.get(i,j);
+            else        res = B.get(i,j);
+            (void)res;
+        }
+        else if (op == 2) { // set
+            int m, i, j;
+            long long v;
+            std::cin >> m >> i >> j >> v;
+            if (m == 1) A.set(i,j,v);
+            else        B.set(i,j,v);
+        }
+        else if (op == 3) { // transpose
+            int m;
+            std::cin >> m;
+            if (m == 1) A.toggleTranspose();
+            else        B.toggleTranspose();
+        }
+        else if (op == 4) { // soma
+            SparseMatrix C = A.add(B);
+        }
+        else if (op == 5) { // scale
+            int m; long long alpha;
+            std::cin >> m >> alpha;
+            if (m == 1) { SparseMatrix C = A.scale(alpha); }
+            else        { SparseMatrix C = B.scale(alpha); }
+        }
+        else if (op == 6) { // mult
+            SparseMatrix C = A.multiply(B);
+        }
+    }
+    return 0;
+}
@@ -2,134 +2,286 @@
 #include <vector>
 #include <tuple>
 #include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
-// Algoritmo de referência: Vector de pares (Coordinate List).
+// Matriz densa de verdade: buffer contíguo row-major com resíduos em [0, MOD).
+// get/set O(1); soma e escala vetorizadas; multiplicação por GEMM bloqueado
+// para cache, com micro-kernel em registradores e redução modular preguiçosa.
+// Compilar com: g++ -O3 -march=native -std=c++17 -pthread algoritmo_denso.cpp
 // Prints removidos para benchmark.
 
 const long long MOD = 1000000;
 
+// Limite de dimensão: N*N resíduos de 4 bytes (16384 -> 1 GiB por matriz).
+const int MAX_N = 16384;
+
 class DenseMatrix {
 public:
-    using Element = std::pair<std::pair<int, int>, long long>;
-    
+    // Blocagem estilo Goto: painel de B (KC x NC) em L2/L3, painel de A
+    // (MC x KC) em L2 e bloco MR x NR de C em registradores.
+    static constexpr int MR = 4;
+    static constexpr int NR = 8;
+    static constexpr int MC = 128;
+    static constexpr int KC = 256;
+    static constexpr int NC = 1024;
+
+    // Abaixo disso o custo de criar threads domina o produto.
+    static constexpr int PARALLEL_MIN_N = 256;
+
     int n;
     bool is_transposed;
-    std::vector<Element> elements;
+    std::vector<uint32_t> data;
 
-    DenseMatrix(int n_ = 0) : n(n_), is_transposed(false) {}
+    explicit DenseMatrix(int n_ = 0)
+        : n(n_), is_transposed(false), data((size_t)n_ * n_, 0) {}
 
     DenseMatrix(int n_, const std::vector<std::tuple<int,int,long long>>& elems)
-        : n(n_), is_transposed(false) {
+        : DenseMatrix(n_) {
         for (auto &t : elems) {
             int i, j; long long v;
             std::tie(i,j,v) = t;
-            if (v != 0) {
-                elements.push_back({{i, j}, v});
-            }
+            set(i, j, v);
         }
     }
 
-    long long get(int i, int j) const {
-        int target_r = is_transposed ? j : i;
-        int target_c = is_transposed ? i : j;
+    static uint32_t reduce(long long v) {
+        long long r = v % MOD;
+        if (r < 0) r += MOD;
+        return (uint32_t)r;
+    }
 
-        for (const auto& el : elements) {
-            if (el.first.first == target_r && el.first.second == target_c) {
-                return el.second;
-            }
-        }
-        return 0;
+    // Posição física do elemento lógico (i,j) considerando a view transposta.
+    size_t index(int i, int j) const {
+        return is_transposed ? (size_t)j * n + i : (size_t)i * n + j;
+    }
+
+    long long get(int i, int j) const {
+        return data[index(i, j)];
     }
 
     void set(int i, int j, long long v) {
-        int target_r = is_transposed ? j : i;
-        int target_c = is_transposed ? i : j;
-
-        for (auto it = elements.begin(); it != elements.end(); ++it) {
-            if (it->first.first == target_r && it->first.second == target_c) {
-                if (v == 0) {
-                    elements.erase(it);
-                } else {
-                    it->second = v;
-                }
-                return;
-            }
-        }
-        if (v != 0) {
-            elements.push_back({{target_r, target_c}, v});
-        }
+        data[index(i, j)] = reduce(v);
     }
 
     void toggleTranspose() {
         is_transposed = !is_transposed;
     }
 
-    static void addToResult(std::vector<Element>& res, int r, int c, long long val) {
-        if (val == 0) return;
-        for (auto& el : res) {
-            if (el.first.first == r && el.first.second == c) {
-                el.second = (el.second + val) % MOD;
-                if (el.second < 0) el.second += MOD;
-                return;
+    DenseMatrix add(const DenseMatrix &B) const {
+        if (n != B.n) throw std::runtime_error("Dimension mismatch in add");
+        DenseMatrix C(n);
+        C.is_transposed = is_transposed;
+
+        const uint32_t *a = data.data();
+        const uint32_t *b = B.data.data();
+        uint32_t *c = C.data.data();
+
+        if (is_transposed == B.is_transposed) {
+            addVec(a, b, c, data.size());
+            return C;
+        }
+
+        // Orientações diferentes: B é lido transposto em blocos que cabem
+        // em L1, evitando percorrer o buffer inteiro com stride n.
+        const int T = 64;
+        for (int bi = 0; bi < n; bi += T) {
+            int ie = std::min(bi + T, n);
+            for (int bj = 0; bj < n; bj += T) {
+                int je = std::min(bj + T, n);
+                for (int i = bi; i < ie; ++i) {
+                    for (int j = bj; j < je; ++j) {
+                        uint32_t s = a[(size_t)i * n + j] + b[(size_t)j * n + i];
+                        c[(size_t)i * n + j] = s >= MOD ? s - (uint32_t)MOD : s;
+                    }
+                }
             }
         }
-        res.push_back({{r, c}, val});
+        return C;
     }
 
-    DenseMatrix add(const DenseMatrix &B) const {
+    DenseMatrix scale(long long alpha) const {
+        DenseMatrix C(n);
+        C.is_transposed = is_transposed;
+        uint32_t w = reduce(alpha);
+        if (w == 0) return C;
+        scaleVec(data.data(), C.data.data(), data.size(), w);
+        return C;
+    }
+
+    // C = A * B (mod MOD). threads = 0 escolhe automaticamente.
+    DenseMatrix multiply(const DenseMatrix &B, unsigned threads = 0) const {
+        if (n != B.n) throw std::runtime_error("Dimension mismatch in multiply");
         DenseMatrix C(n);
-        for (const auto& el : elements) {
-            int r = is_transposed ? el.first.second : el.first.first;
-            int c = is_transposed ? el.first.first : el.first.second;
-            addToResult(C.elements, r, c, el.second);
+        if (n == 0) return C;
+
+        if (threads == 0) {
+            threads = n < PARALLEL_MIN_N ? 1 : std::thread::hardware_concurrency();
+            if (threads == 0) threads = 1;
         }
-        for (const auto& el : B.elements) {
-            int r = B.is_transposed ? el.first.second : el.first.first;
-            int c = B.is_transposed ? el.first.first : el.first.second;
-            addToResult(C.elements, r, c, el.second);
+
+        // Cada thread calcula uma faixa de linhas de C (múltipla de MR),
+        // então não há escrita compartilhada.
+        int band = (n + (int)threads - 1) / (int)threads;
+        band = (band + MR - 1) / MR * MR;
+
+        std::vector<std::thread> pool;
+        for (int r0 = band; r0 < n; r0 += band) {
+            int r1 = std::min(r0 + band, n);
+            pool.emplace_back([this, &B, &C, r0, r1]{ gemmRows(B, C, r0, r1); });
         }
+        gemmRows(B, C, 0, std::min(band, n));
+        for (auto &t : pool) t.join();
         return C;
     }
 
-    DenseMatrix scale(long long alpha) const {
-        DenseMatrix C(n);
-        if (alpha == 0) return C;
-        for (const auto& el : elements) {
-            int r = is_transposed ? el.first.second : el.first.first;
-            int c = is_transposed ? el.first.first : el.first.second;
-            long long val = (el.second % MOD) * (alpha % MOD);
-            val %= MOD;
-            if (val < 0) val += MOD;
-            if (val != 0) {
-                C.elements.push_back({{r, c}, val});
+private:
+    // Elemento lógico (i,j) como stride de linha/coluna sobre o buffer.
+    struct View {
+        const uint32_t *p;
+        size_t rs, cs;
+        uint32_t at(int i, int j) const { return p[i * rs + j * cs]; }
+    };
+
+    View view() const {
+        return is_transposed ? View{data.data(), 1, (size_t)n}
+                             : View{data.data(), (size_t)n, 1};
+    }
+
+    static void addVec(const uint32_t *__restrict a, const uint32_t *__restrict b,
+                       uint32_t *__restrict c, size_t len) {
+        // Resíduos < MOD < 2^31: a soma não transborda e uma subtração
+        // condicional substitui o %.
+        for (size_t t = 0; t < len; ++t) {
+            uint32_t s = a[t] + b[t];
+            c[t] = s >= MOD ? s - (uint32_t)MOD : s;
+        }
+    }
+
+    static void scaleVec(const uint32_t *__restrict a, uint32_t *__restrict c,
+                         size_t len, uint32_t w) {
+        // Multiplicação de Shoup: com w' = floor(w * 2^32 / MOD), q = (x * w') >> 32
+        // erra o quociente por no máximo 1, logo x*w - q*MOD fica em [0, 2*MOD).
+        const uint32_t m = (uint32_t)MOD;
+        const uint32_t wp = (uint32_t)(((uint64_t)w << 32) / m);
+        size_t t = 0;
+#if defined(__AVX2__)
+        const __m256i vw = _mm256_set1_epi32((int)w);
+        const __m256i vwp = _mm256_set1_epi64x(wp);
+        const __m256i vm = _mm256_set1_epi32((int)m);
+        const __m256i vm1 = _mm256_set1_epi32((int)(m - 1));
+        for (; t + 8 <= len; t += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i *)(a + t));
+            __m256i qe = _mm256_srli_epi64(_mm256_mul_epu32(x, vwp), 32);
+            __m256i qo = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), vwp);
+            __m256i q = _mm256_blend_epi32(qe, qo, 0xAA);
+            __m256i r = _mm256_sub_epi32(_mm256_mullo_epi32(x, vw),
+                                         _mm256_mullo_epi32(q, vm));
+            __m256i ge = _mm256_cmpgt_epi32(r, vm1);
+            r = _mm256_sub_epi32(r, _mm256_and_si256(ge, vm));
+            _mm256_storeu_si256((__m256i *)(c + t), r);
+        }
+#endif
+        for (; t < len; ++t) {
+            uint32_t x = a[t];
+            uint32_t q = (uint32_t)(((uint64_t)x * wp) >> 32);
+            uint32_t r = x * w - q * m;
+            c[t] = r >= m ? r - m : r;
+        }
+    }
+
+    // acc[MR][NR] = soma_p a[p][:] * b[p][:], sem redução: kc <= KC produtos
+    // de resíduos (< 2^40 cada) cabem com folga em 64 bits.
+    static void microKernel(int kc, const uint32_t *a, const uint64_t *b,
+                            uint64_t acc[MR][NR]) {
+#if defined(__AVX2__)
+        __m256i c[MR][2];
+        for (int ii = 0; ii < MR; ++ii) {
+            c[ii][0] = _mm256_setzero_si256();
+            c[ii][1] = _mm256_setzero_si256();
+        }
+        for (int p = 0; p < kc; ++p) {
+            __m256i b0 = _mm256_loadu_si256((const __m256i *)(b + p * NR));
+            __m256i b1 = _mm256_loadu_si256((const __m256i *)(b + p * NR + 4));
+            for (int ii = 0; ii < MR; ++ii) {
+                __m256i av = _mm256_set1_epi64x(a[p * MR + ii]);
+                c[ii][0] = _mm256_add_epi64(c[ii][0], _mm256_mul_epu32(av, b0));
+                c[ii][1] = _mm256_add_epi64(c[ii][1], _mm256_mul_epu32(av, b1));
             }
         }
-        return C;
+        for (int ii = 0; ii < MR; ++ii) {
+            _mm256_storeu_si256((__m256i *)acc[ii], c[ii][0]);
+            _mm256_storeu_si256((__m256i *)(acc[ii] + 4), c[ii][1]);
+        }
+#else
+        for (int ii = 0; ii < MR; ++ii)
+            for (int jj = 0; jj < NR; ++jj)
+                acc[ii][jj] = 0;
+        for (int p = 0; p < kc; ++p) {
+            for (int ii = 0; ii < MR; ++ii) {
+                uint64_t av = a[p * MR + ii];
+                for (int jj = 0; jj < NR; ++jj)
+                    acc[ii][jj] += av * b[p * NR + jj];
+            }
+        }
+#endif
     }
 
-    DenseMatrix multiply(const DenseMatrix &B) const {
-        DenseMatrix C(n);
-        for (const auto& elA : elements) {
-            int rA = is_transposed ? elA.first.second : elA.first.first;
-            int cA = is_transposed ? elA.first.first : elA.first.second;
-            long long valA = elA.second;
-
-            for (const auto& elB : B.elements) {
-                int rB = B.is_transposed ? elB.first.second : elB.first.first;
-                int cB = B.is_transposed ? elB.first.first : elB.first.second;
-                long long valB = elB.second;
-
-                if (cA == rB) {
-                    long long prod = (valA % MOD) * (valB % MOD);
-                    prod %= MOD;
-                    addToResult(C.elements, rA, cB, prod);
+    // Linhas [r0, r1) de C = A * B. C é row-major sem transposição.
+    void gemmRows(const DenseMatrix &B, DenseMatrix &C, int r0, int r1) const {
+        const View A = view();
+        const View Bv = B.view();
+        uint32_t *c = C.data.data();
+
+        std::vector<uint32_t> packA((size_t)MC * KC);
+        std::vector<uint64_t> packB((size_t)KC * NC);
+        uint64_t acc[MR][NR];
+
+        for (int jc = 0; jc < n; jc += NC) {
+            int nc = std::min(NC, n - jc);
+            for (int pc = 0; pc < n; pc += KC) {
+                int kc = std::min(KC, n - pc);
+
+                // Painel de B em fatias de NR colunas, completadas com zero.
+                for (int jr = 0; jr < nc; jr += NR) {
+                    uint64_t *dst = &packB[(size_t)jr * kc];
+                    for (int p = 0; p < kc; ++p)
+                        for (int jj = 0; jj < NR; ++jj)
+                            dst[p * NR + jj] = jr + jj < nc ? Bv.at(pc + p, jc + jr + jj) : 0;
+                }
+
+                for (int ic = r0; ic < r1; ic += MC) {
+                    int mc = std::min(MC, r1 - ic);
+
+                    // Painel de A em fatias de MR linhas, completadas com zero.
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        uint32_t *dst = &packA[(size_t)ir * kc];
+                        for (int p = 0; p < kc; ++p)
+                            for (int ii = 0; ii < MR; ++ii)
+                                dst[p * MR + ii] = ir + ii < mc ? A.at(ic + ir + ii, pc + p) : 0;
+                    }
+
+                    for (int jr = 0; jr < nc; jr += NR) {
+                        int nr = std::min(NR, nc - jr);
+                        for (int ir = 0; ir < mc; ir += MR) {
+                            int mr = std::min(MR, mc - ir);
+                            microKernel(kc, &packA[(size_t)ir * kc], &packB[(size_t)jr * kc], acc);
+
+                            // Redução preguiçosa: um % por elemento de C a cada KC produtos.
+                            for (int ii = 0; ii < mr; ++ii) {
+                                uint32_t *row = c + (size_t)(ic + ir + ii) * n + jc + jr;
+                                for (int jj = 0; jj < nr; ++jj)
+                                    row[jj] = (uint32_t)((row[jj] + acc[ii][jj]) % MOD);
+                            }
+                        }
+                    }
                 }
             }
         }
-        for (auto& el : C.elements) {
-            if (el.second < 0) el.second += MOD;
-        }
-        return C;
     }
 };
 
@@ -139,6 +291,7 @@ int main() {
 
     int k1, N1;
     if (!(std::cin >> k1 >> N1)) return 0;
+    if (N1 < 0 || N1 > MAX_N) return 1;
     std::vector<std::tuple<int,int,long long>> elems1;
     elems1.reserve(k1);
     for (int t = 0; t < k1; ++t) {
@@ -150,6 +303,7 @@ int main() {
 
     int k2, N2;
     std::cin >> k2 >> N2;
+    if (N1 != N2) return 1;
     std::vector<std::tuple<int,int,long long>> elems2;
     elems2.reserve(k2);
     for (int t = 0; t < k2; ++t) {
@@ -159,8 +313,6 @@ int main() {
     }
     DenseMatrix B(N2, elems2);
 
-    if (N1 != N2) return 1;
-
     int Q;
     if (!(std::cin >> Q)) return 0;
 
@@ -203,4 +355,4 @@ int main() {
         }
     }
     return 0;
-}
\ No newline at end of file
+}
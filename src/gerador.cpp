@@ -1,79 +1,438 @@
 /*
  * gerador.cpp
- * Compilar com: g++ -o gerador gerador.cpp -O3 -std=c++17
- * * Uso: ./gerador [N] [k]
+ * Compilar com: g++ -o gerador gerador.cpp -O3 -std=c++17 -pthread
+ * * Uso: ./gerador [N] [k] [opções]
  * [N]: dimensão da matriz (N x N)
- * [k]: número de elementos não nulos
+ * [k]: número de elementos (linhas de saída)
  *
- * Saída: Imprime k linhas no formato "linha coluna valor" para stdout
+ * Opções:
+ *   --dist D        uniforme | potencia | banda | blocos | duplicados (padrão: uniforme)
+ *   --alpha A       expoente da lei de potência das linhas (padrão: 1.0)
+ *   --banda B       semi-largura da banda (padrão: mínima que comporta k)
+ *   --bloco S       tamanho dos blocos diagonais (padrão: mínimo que comporta k)
+ *   --dup F         repetições médias por posição em "duplicados" (padrão: 4)
+ *   --valores A B   intervalo dos valores (padrão: 1 100)
+ *   --seed S        semente (padrão: aleatória); a saída não depende de --threads
+ *   --threads T     número de threads (padrão: hardware_concurrency)
+ *   --ordem O       linhas | aleatoria (padrão: linhas); ver abaixo
+ *   --binario       saída binária em vez de texto
+ *   -o ARQ          arquivo de saída (padrão: stdout)
+ *
+ * Saída texto: "k N" seguido de k linhas "linha coluna valor" (mesmo formato
+ * de matriz lido pelos algoritmos).
+ * Saída binária (little-endian): uint64 k, uint64 N, e k registros
+ * { int32 linha, int32 coluna, int32 valor }.
+ *
+ * As posições são únicas (exceto em "duplicados", onde as repetições são
+ * intencionais e a última ocorrência prevalece). Em vez de um conjunto global,
+ * primeiro sorteia-se quantos elementos cada linha recebe e depois cada linha
+ * sorteia suas colunas de forma independente, em paralelo.
+ *
+ * Ordem de saída: em "linhas" os registros saem ordenados por linha e, dentro
+ * da linha, por coluna (exceto as repetições de "duplicados"), gerados e
+ * escritos em fluxo. Essa ordem é o melhor caso de carga para estruturas
+ * ordenadas; "aleatoria" guarda os k registros em memória (12 bytes cada) e
+ * os embaralha com a semente antes de escrever, então a saída continua
+ * independente de --threads.
  */
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <vector>
 #include <random>       // Para geração de números aleatórios
-#include <unordered_set> // Para garantir posições (i, j) únicas
-#include <functional>   // Para std::hash
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <charconv>     // Para std::to_chars
+#include <cmath>
+#include <cstdint>
 
-// Estrutura para representar uma posição (linha, coluna)
-struct Position {
-    int row;
-    int col;
+enum class Dist { Uniforme, Potencia, Banda, Blocos, Duplicados };
+enum class Ordem { Linhas, Aleatoria };
 
-    // Operador '==' para o unordered_set
-    bool operator==(const Position& other) const {
-        return row == other.row && col == other.col;
-    }
+struct Config {
+    long long N = 0;
+    long long k = 0;
+    Dist dist = Dist::Uniforme;
+    double alpha = 1.0;
+    long long banda = -1;
+    long long bloco = -1;
+    double dup = 4.0;
+    int vmin = 1;
+    int vmax = 100;
+    uint64_t seed = 0;
+    unsigned threads = 0;
+    Ordem ordem = Ordem::Linhas;
+    bool binario = false;
+    std::string saida;
 };
 
-// Hash customizado para que Position possa ser usada no unordered_set
-namespace std {
-    template <>
-    struct hash<Position> {
-        size_t operator()(const Position& p) const {
-            // Combina o hash da linha e da coluna
-            size_t h1 = hash<int>{}(p.row);
-            size_t h2 = hash<int>{}(p.col);
-            return h1 ^ (h2 << 1); // Combinação simples de hash
+// Linhas por bloco de trabalho: cada bloco tem sua própria semente, então a
+// saída é a mesma para qualquer número de threads.
+const long long ROWS_PER_BLOCK = 1024;
+
+// Registros formatados por tarefa na escrita da ordem aleatória.
+const size_t REGS_POR_TRECHO = 1 << 16;
+
+struct Registro { int32_t i, j, v; };
+
+// Deriva sementes independentes a partir de (seed, índice).
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Intervalo de colunas [lo, hi) permitido para a linha r.
+static void rowRange(const Config& cfg, long long r, long long& lo, long long& hi) {
+    switch (cfg.dist) {
+        case Dist::Banda:
+            lo = std::max(0LL, r - cfg.banda);
+            hi = std::min(cfg.N, r + cfg.banda + 1);
+            break;
+        case Dist::Blocos:
+            lo = r / cfg.bloco * cfg.bloco;
+            hi = std::min(cfg.N, lo + cfg.bloco);
+            break;
+        default:
+            lo = 0;
+            hi = cfg.N;
+    }
+}
+
+// Distribui 'total' elementos entre as linhas proporcionalmente a 'peso',
+// respeitando a capacidade de cada linha. Binomiais condicionais sequenciais
+// dão uma multinomial exata; o excedente cortado pela capacidade é
+// redistribuído numa varredura final.
+static std::vector<long long> distribuiContagens(long long total,
+                                                 const std::vector<double>& peso,
+                                                 const std::vector<long long>& cap,
+                                                 std::mt19937_64& gen) {
+    size_t n = peso.size();
+    std::vector<long long> cnt(n, 0);
+    double restantePeso = 0;
+    for (double w : peso) restantePeso += w;
+
+    long long restante = total;
+    for (size_t r = 0; r < n && restante > 0; ++r) {
+        long long c;
+        if (r + 1 == n || peso[r] >= restantePeso) {
+            c = restante;
+        } else {
+            double p = peso[r] / restantePeso;
+            std::binomial_distribution<long long> bin(restante, std::min(1.0, std::max(0.0, p)));
+            c = bin(gen);
         }
+        c = std::min(c, cap[r]);
+        cnt[r] = c;
+        restante -= c;
+        restantePeso -= peso[r];
+    }
+
+    for (size_t r = 0; r < n && restante > 0; ++r) {
+        long long extra = std::min(restante, cap[r] - cnt[r]);
+        cnt[r] += extra;
+        restante -= extra;
+    }
+    return cnt;
+}
+
+// Sorteia 'c' colunas distintas em [lo, hi), em ordem crescente.
+static void sorteiaColunas(long long lo, long long hi, long long c,
+                           std::mt19937_64& gen, std::vector<int>& out) {
+    out.clear();
+    long long largura = hi - lo;
+    if (c <= 0) return;
+
+    if (2 * c >= largura) {
+        // Linha densa: seleção sequencial (Knuth, algoritmo S), O(largura).
+        long long faltam = c;
+        for (long long t = 0; t < largura && faltam > 0; ++t) {
+            std::uniform_int_distribution<long long> d(0, largura - t - 1);
+            if (d(gen) < faltam) {
+                out.push_back((int)(lo + t));
+                --faltam;
+            }
+        }
+        return;
+    }
+
+    // Linha esparsa: sorteia, ordena e completa as colisões (poucas, pois c < largura/2).
+    std::uniform_int_distribution<long long> d(lo, hi - 1);
+    while ((long long)out.size() < c) {
+        long long falta = c - (long long)out.size();
+        for (long long t = 0; t < falta; ++t) out.push_back((int)d(gen));
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
+
+static char* escreveInt(char* p, long long v) {
+    return std::to_chars(p, p + 24, v).ptr;
+}
+
+// Formata n registros em 'buf' (texto ou binário).
+static void formata(const Config& cfg, const Registro* regs, size_t n, std::string& buf) {
+    buf.clear();
+    for (size_t t = 0; t < n; ++t) {
+        const Registro& r = regs[t];
+        if (cfg.binario) {
+            int32_t rec[3] = { r.i, r.j, r.v };
+            buf.append(reinterpret_cast<const char*>(rec), sizeof(rec));
+        } else {
+            char tmp[64];
+            char* p = escreveInt(tmp, r.i);
+            *p++ = ' ';
+            p = escreveInt(p, r.j);
+            *p++ = ' ';
+            p = escreveInt(p, r.v);
+            *p++ = '\n';
+            buf.append(tmp, p - tmp);
+        }
+    }
+}
+
+// Executa f(t) para t em [ini, fim) distribuindo entre as threads.
+template <class Func>
+static void emParalelo(unsigned threads, long long ini, long long fim, Func f) {
+    std::atomic<long long> proximo(ini);
+    auto trabalho = [&]() {
+        for (long long t = proximo++; t < fim; t = proximo++) f(t);
     };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(trabalho);
+    trabalho();
+    for (auto& t : pool) t.join();
+}
+
+// Gera os registros das linhas do bloco b em 'regs', em ordem de linha.
+static void geraBloco(const Config& cfg, long long b,
+                      const std::vector<long long>& unicos,
+                      const std::vector<long long>& repeticoes,
+                      std::vector<Registro>& regs) {
+    std::mt19937_64 gen(splitmix64(cfg.seed ^ splitmix64((uint64_t)b)));
+    std::uniform_int_distribution<int> dist_val(cfg.vmin, cfg.vmax);
+    std::vector<int> cols;
+    std::vector<int> emissao;
+
+    regs.clear();
+    long long r0 = b * ROWS_PER_BLOCK;
+    long long r1 = std::min(cfg.N, r0 + ROWS_PER_BLOCK);
+    for (long long r = r0; r < r1; ++r) {
+        if (unicos[r] == 0) continue;
+        long long lo, hi;
+        rowRange(cfg, r, lo, hi);
+        sorteiaColunas(lo, hi, unicos[r], gen, cols);
+
+        if (repeticoes.empty()) {
+            for (int c : cols) regs.push_back({ (int32_t)r, c, dist_val(gen) });
+            continue;
+        }
+
+        // "duplicados": repete colunas já sorteadas e embaralha para que as
+        // repetições fiquem intercaladas com a primeira ocorrência.
+        emissao.assign(cols.begin(), cols.end());
+        std::uniform_int_distribution<size_t> pick(0, cols.size() - 1);
+        for (long long t = 0; t < repeticoes[r]; ++t) emissao.push_back(cols[pick(gen)]);
+        std::shuffle(emissao.begin(), emissao.end(), gen);
+        for (int c : emissao) regs.push_back({ (int32_t)r, c, dist_val(gen) });
+    }
+}
+
+static bool parseArgs(int argc, char* argv[], Config& cfg) {
+    if (argc < 3) return false;
+    cfg.N = std::stoll(argv[1]);
+    cfg.k = std::stoll(argv[2]);
+    cfg.seed = std::random_device{}();
+
+    for (int a = 3; a < argc; ++a) {
+        std::string op = argv[a];
+        auto prox = [&]() -> std::string {
+            if (a + 1 >= argc) throw std::invalid_argument("faltou valor para " + op);
+            return argv[++a];
+        };
+        if (op == "--dist") {
+            std::string d = prox();
+            if (d == "uniforme") cfg.dist = Dist::Uniforme;
+            else if (d == "potencia") cfg.dist = Dist::Potencia;
+            else if (d == "banda") cfg.dist = Dist::Banda;
+            else if (d == "blocos") cfg.dist = Dist::Blocos;
+            else if (d == "duplicados") cfg.dist = Dist::Duplicados;
+            else throw std::invalid_argument("distribuição desconhecida: " + d);
+        }
+        else if (op == "--alpha") cfg.alpha = std::stod(prox());
+        else if (op == "--banda") cfg.banda = std::stoll(prox());
+        else if (op == "--bloco") cfg.bloco = std::stoll(prox());
+        else if (op == "--dup") cfg.dup = std::stod(prox());
+        else if (op == "--valores") { cfg.vmin = std::stoi(prox()); cfg.vmax = std::stoi(prox()); }
+        else if (op == "--seed") cfg.seed = std::stoull(prox());
+        else if (op == "--threads") cfg.threads = (unsigned)std::stoul(prox());
+        else if (op == "--ordem") {
+            std::string o = prox();
+            if (o == "linhas") cfg.ordem = Ordem::Linhas;
+            else if (o == "aleatoria") cfg.ordem = Ordem::Aleatoria;
+            else throw std::invalid_argument("ordem desconhecida: " + o);
+        }
+        else if (op == "--binario") cfg.binario = true;
+        else if (op == "-o") cfg.saida = prox();
+        else throw std::invalid_argument("opção desconhecida: " + op);
+    }
+    return true;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cerr << "Uso: ./gerador [N] [k]" << std::endl;
+    Config cfg;
+    try {
+        if (!parseArgs(argc, argv, cfg)) {
+            std::cerr << "Uso: ./gerador [N] [k] [--dist D] [--alpha A] [--banda B] [--bloco S]"
+                         " [--dup F] [--valores A B] [--seed S] [--threads T] [--ordem O] [--binario] [-o ARQ]"
+                      << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << std::endl;
         return 1;
     }
 
     std::ios_base::sync_with_stdio(false);
     std::cin.tie(NULL);
 
-    long long N = std::stoll(argv[1]);
-    long long k = std::stoll(argv[2]);
+    if (cfg.N <= 0 || cfg.k < 0 || cfg.vmin > cfg.vmax) {
+        std::cerr << "Erro: parâmetros inválidos." << std::endl;
+        return 1;
+    }
+    if (cfg.threads == 0) cfg.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Elementos distintos: em "duplicados" só uma fração de k é única.
+    long long distintos = cfg.k;
+    if (cfg.dist == Dist::Duplicados) {
+        if (cfg.dup < 1.0) cfg.dup = 1.0;
+        distintos = std::max(cfg.k > 0 ? 1LL : 0LL, (long long)std::ceil(cfg.k / cfg.dup));
+    }
+
+    // Parâmetros automáticos: a menor estrutura que comporta os elementos.
+    long long porLinha = (distintos + cfg.N - 1) / cfg.N;
+    if (cfg.dist == Dist::Banda && cfg.banda < 0) cfg.banda = porLinha;
+    if (cfg.dist == Dist::Blocos && cfg.bloco <= 0) {
+        // O bloco final parcial (N % S linhas) reduz a capacidade: procura o
+        // menor S cuja capacidade real, S*S por bloco cheio mais o resto, basta.
+        cfg.bloco = std::max(porLinha, 1LL);
+        while (cfg.bloco < cfg.N &&
+               (cfg.N / cfg.bloco) * cfg.bloco * cfg.bloco + (cfg.N % cfg.bloco) * (cfg.N % cfg.bloco) < distintos)
+            ++cfg.bloco;
+    }
+    if (cfg.bloco > cfg.N) cfg.bloco = cfg.N;
+
+    std::vector<double> peso(cfg.N);
+    std::vector<long long> cap(cfg.N);
+    long long capTotal = 0;
+    for (long long r = 0; r < cfg.N; ++r) {
+        long long lo, hi;
+        rowRange(cfg, r, lo, hi);
+        cap[r] = hi - lo;
+        capTotal += cap[r];
+        peso[r] = (double)cap[r];
+    }
 
-    printf("%lld %lld\n", N, k);
+    if (distintos > capTotal) {
+        std::cerr << "Erro: k não cabe na distribuição escolhida (capacidade " << capTotal << ")." << std::endl;
+        return 1;
+    }
 
-    if (k > N * N) {
-        std::cerr << "Erro: k não pode ser maior que N*N." << std::endl;
-        k = N * N;
+    std::mt19937_64 gen(splitmix64(cfg.seed));
+
+    if (cfg.dist == Dist::Potencia) {
+        // Peso da linha de posto p é 1/(p+1)^alpha; os postos são permutados
+        // para que as linhas pesadas fiquem espalhadas pela matriz.
+        std::vector<long long> posto(cfg.N);
+        for (long long r = 0; r < cfg.N; ++r) posto[r] = r;
+        std::shuffle(posto.begin(), posto.end(), gen);
+        for (long long r = 0; r < cfg.N; ++r)
+            peso[r] = std::pow((double)(posto[r] + 1), -cfg.alpha);
     }
 
-    // Geradores de números aleatórios
-    std::mt19937 gen(std::random_device{}()); // Motor de geração
-    std::uniform_int_distribution<long long> dist_pos(0, N - 1);
-    std::uniform_int_distribution<int> dist_val(1, 100);
+    std::vector<long long> unicos = distribuiContagens(distintos, peso, cap, gen);
 
-    std::unordered_set<Position> generated_positions;
-    generated_positions.reserve(k); 
+    std::vector<long long> repeticoes;
+    if (cfg.dist == Dist::Duplicados) {
+        std::vector<double> pesoRep(cfg.N);
+        std::vector<long long> capRep(cfg.N);
+        for (long long r = 0; r < cfg.N; ++r) {
+            pesoRep[r] = (double)unicos[r];
+            capRep[r] = unicos[r] > 0 ? cfg.k : 0;
+        }
+        repeticoes = distribuiContagens(cfg.k - distintos, pesoRep, capRep, gen);
+    }
 
-    for (long long i = 0; i < k; ++i) {
-        Position pos;
-        do {
-            pos = { (int)dist_pos(gen), (int)dist_pos(gen) };
-        } while (!generated_positions.insert(pos).second); 
+    std::ofstream arquivo;
+    if (!cfg.saida.empty()) {
+        arquivo.open(cfg.saida, std::ios::binary);
+        if (!arquivo) {
+            std::cerr << "Erro: não foi possível abrir " << cfg.saida << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = cfg.saida.empty() ? std::cout : arquivo;
 
-        std::cout << pos.row << " " << pos.col << " " << dist_val(gen) << "\n";
+    if (cfg.binario) {
+        uint64_t header[2] = { (uint64_t)cfg.k, (uint64_t)cfg.N };
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    } else {
+        out << cfg.k << " " << cfg.N << "\n";
     }
 
-    return 0;
-}
\ No newline at end of file
+    long long numBlocos = (cfg.N + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+
+    if (cfg.ordem == Ordem::Linhas) {
+        // Blocos processados em ondas: as threads geram em paralelo e a thread
+        // principal escreve os buffers em ordem, limitando a memória usada.
+        long long porOnda = (long long)cfg.threads * 4;
+        std::vector<std::vector<Registro>> regs(porOnda);
+        std::vector<std::string> buffers(porOnda);
+
+        for (long long base = 0; base < numBlocos; base += porOnda) {
+            long long fim = std::min(numBlocos, base + porOnda);
+            emParalelo(cfg.threads, base, fim, [&](long long b) {
+                auto& r = regs[b - base];
+                geraBloco(cfg, b, unicos, repeticoes, r);
+                formata(cfg, r.data(), r.size(), buffers[b - base]);
+            });
+            for (long long b = base; b < fim; ++b)
+                out.write(buffers[b - base].data(), buffers[b - base].size());
+        }
+    } else {
+        // Os blocos são concatenados em ordem de bloco e embaralhados com
+        // 'gen', cujo estado só depende da semente: a permutação não muda
+        // com o número de threads.
+        std::vector<std::vector<Registro>> porBloco(numBlocos);
+        emParalelo(cfg.threads, 0, numBlocos, [&](long long b) {
+            geraBloco(cfg, b, unicos, repeticoes, porBloco[b]);
+        });
+        std::vector<Registro> todos;
+        todos.reserve(cfg.k);
+        for (auto& r : porBloco) {
+            todos.insert(todos.end(), r.begin(), r.end());
+            std::vector<Registro>().swap(r);
+        }
+        std::shuffle(todos.begin(), todos.end(), gen);
+
+        long long numTrechos = (long long)((todos.size() + REGS_POR_TRECHO - 1) / REGS_POR_TRECHO);
+        long long porOnda = (long long)cfg.threads * 4;
+        std::vector<std::string> buffers(porOnda);
+        for (long long base = 0; base < numTrechos; base += porOnda) {
+            long long fim = std::min(numTrechos, base + porOnda);
+            emParalelo(cfg.threads, base, fim, [&](long long t) {
+                size_t ini = (size_t)t * REGS_POR_TRECHO;
+                size_t n = std::min(REGS_POR_TRECHO, todos.size() - ini);
+                formata(cfg, todos.data() + ini, n, buffers[t - base]);
+            });
+            for (long long t = base; t < fim; ++t)
+                out.write(buffers[t - base].data(), buffers[t - base].size());
+        }
+    }
+
+    out.flush();
+    return out ? 0 : 1;
+}